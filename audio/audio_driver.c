@@ -55,7 +55,9 @@
 #include "../list_special.h"
 #include "../file_path_special.h"
 #include "../record/record_driver.h"
+#include "../performance_counters.h"
 #include "../tasks/task_content.h"
+#include "../trace.h"
 #include "../verbosity.h"
 
 #define MENU_SOUND_FORMATS "ogg|mod|xm|s3m|mp3|flac|wav"
@@ -410,11 +412,15 @@ static void audio_driver_flush(
       bool is_slowmotion, bool is_fastforward)
 {
    struct resampler_data src_data;
+   static struct retro_perf_counter audio_resample_perf = {0};
+   bool perfcnt_enable               = runloop_state_get_ptr()->perfcnt_enable;
    float audio_volume_gain           = (audio_st->mute_enable ||
          (audio_fastforward_mute && is_fastforward))
                ? 0.0f
                : audio_st->volume_gain;
 
+   TRACE_BEGIN("audio_driver_flush");
+
    src_data.data_out                 = NULL;
    src_data.output_frames            = 0;
    /* We'll assign a proper output to the resampler later in this function */
@@ -528,8 +534,11 @@ static void audio_driver_flush(
       audio_st->last_flush_time = flush_time;
    }
 
+   performance_counter_init(audio_resample_perf, "audio_resample");
+   performance_counter_start_plus(perfcnt_enable, audio_resample_perf);
    audio_st->resampler->process(
          audio_st->resampler_data, &src_data);
+   performance_counter_stop_plus(perfcnt_enable, audio_resample_perf);
 
 #ifdef HAVE_AUDIOMIXER
    if (audio_st->flags & AUDIO_FLAG_MIXER_ACTIVE)
@@ -570,6 +579,8 @@ static void audio_driver_flush(
       audio_st->current_audio->write(audio_st->context_audio_data,
             output_data, output_frames * 2);
    }
+
+   TRACE_END("audio_driver_flush");
 }
 
 #ifdef HAVE_AUDIOMIXER
@@ -0,0 +1,208 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2023 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <compat/strl.h>
+#include <features/features_cpu.h>
+#include <formats/rjson.h>
+
+#include "benchmark.h"
+#include "performance_counters.h"
+#include "retroarch.h"
+#include "runloop.h"
+#include "verbosity.h"
+
+static benchmark_state_t benchmark_st;
+
+benchmark_state_t *benchmark_state_get_ptr(void)
+{
+   return &benchmark_st;
+}
+
+bool benchmark_init(unsigned frames, bool keep_drivers)
+{
+   benchmark_state_t *bench_st = &benchmark_st;
+
+   if (frames == 0)
+      frames = BENCHMARK_DEFAULT_FRAMES;
+
+   free(bench_st->frame_times);
+   if (!(bench_st->frame_times = (retro_time_t*)
+            calloc(frames, sizeof(*bench_st->frame_times))))
+      return false;
+
+   bench_st->max_frames  = frames;
+   bench_st->num_frames  = 0;
+   bench_st->start_time  = 0;
+   bench_st->last_time   = 0;
+   bench_st->start_ticks = 0;
+   bench_st->flags       = BENCHMARK_FLAG_ACTIVE;
+   if (keep_drivers)
+      bench_st->flags   |= BENCHMARK_FLAG_KEEP_DRIVERS;
+
+   /* The runloop exits on its own once enough frames ran */
+   runloop_state_get_ptr()->max_frames = frames;
+   retroarch_ctl(RARCH_CTL_SET_PERFCNT_ENABLE, NULL);
+   return true;
+}
+
+void benchmark_apply_settings(settings_t *settings)
+{
+   benchmark_state_t *bench_st = &benchmark_st;
+
+   if (!(bench_st->flags & BENCHMARK_FLAG_ACTIVE))
+      return;
+
+   if (!(bench_st->flags & BENCHMARK_FLAG_KEEP_DRIVERS))
+   {
+      configuration_set_string(settings, settings->arrays.video_driver, "null");
+      configuration_set_string(settings, settings->arrays.audio_driver, "null");
+      configuration_set_string(settings, settings->arrays.input_driver, "null");
+   }
+
+   /* Run uncapped */
+   configuration_set_bool(settings, settings->bools.video_vsync, false);
+   configuration_set_bool(settings, settings->bools.audio_sync, false);
+   configuration_set_bool(settings, settings->bools.vrr_runloop_enable, false);
+   configuration_set_bool(settings, settings->bools.video_frame_rest, false);
+   configuration_set_bool(settings, settings->bools.video_frame_delay_auto, false);
+   configuration_set_uint(settings, settings->uints.video_frame_delay, 0);
+
+   /* None of the above may end up in the user's config */
+   configuration_set_bool(settings, settings->bools.config_save_on_exit, false);
+}
+
+void benchmark_frame(void)
+{
+   benchmark_state_t *bench_st = &benchmark_st;
+   retro_time_t now            = cpu_features_get_time_usec();
+
+   if (!bench_st->start_time)
+   {
+      /* The first frame only marks the start,
+       * so content loading isn't measured */
+      bench_st->start_time  = now;
+      bench_st->start_ticks = cpu_features_get_perf_counter();
+   }
+   else if (bench_st->num_frames < bench_st->max_frames)
+      bench_st->frame_times[bench_st->num_frames++] =
+         now - bench_st->last_time;
+
+   bench_st->last_time = now;
+}
+
+static int benchmark_time_cmp(const void *a, const void *b)
+{
+   retro_time_t x = *(const retro_time_t*)a;
+   retro_time_t y = *(const retro_time_t*)b;
+   return (x > y) - (x < y);
+}
+
+static int benchmark_write_stdout(const void *buf, int len, void *user_data)
+{
+   return (int)fwrite(buf, 1, len, stdout);
+}
+
+void benchmark_report(void)
+{
+   unsigned i;
+   rjsonwriter_t *writer;
+   benchmark_state_t *bench_st           = &benchmark_st;
+   struct retro_perf_counter **counters  = retro_get_perf_counter_rarch();
+   unsigned num_counters                 = retro_get_perf_count_rarch();
+   retro_time_t elapsed                  = 0;
+   double ticks_per_usec                 = 0.0;
+   double fps                            = 0.0;
+   retro_time_t p50                      = 0;
+   retro_time_t p99                      = 0;
+
+   if (!(bench_st->flags & BENCHMARK_FLAG_ACTIVE))
+      return;
+
+   if (bench_st->num_frames)
+   {
+      elapsed        = bench_st->last_time - bench_st->start_time;
+      /* Counters tick at a platform specific rate,
+       * derive it from the wall clock */
+      ticks_per_usec = (double)(cpu_features_get_perf_counter()
+            - bench_st->start_ticks)
+            / (double)(cpu_features_get_time_usec() - bench_st->start_time);
+      if (elapsed > 0)
+         fps         = (double)bench_st->num_frames * 1000000.0 / elapsed;
+
+      qsort(bench_st->frame_times, bench_st->num_frames,
+            sizeof(*bench_st->frame_times), benchmark_time_cmp);
+      p50 = bench_st->frame_times[(bench_st->num_frames - 1) * 50 / 100];
+      p99 = bench_st->frame_times[(bench_st->num_frames - 1) * 99 / 100];
+   }
+
+   if ((writer = rjsonwriter_open_user(benchmark_write_stdout, NULL)))
+   {
+      rjsonwriter_raw(writer, "{", 1);
+      rjsonwriter_raw(writer, "\n", 1);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_add_string(writer, "core");
+      rjsonwriter_raw(writer, ": ", 2);
+      rjsonwriter_add_string(writer,
+            runloop_state_get_ptr()->system.info.library_name);
+      rjsonwriter_raw(writer, ",\n", 2);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_rawf(writer, "\"frames\": %u,\n", bench_st->num_frames);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_rawf(writer, "\"elapsed_ms\": %.3f,\n", elapsed / 1000.0);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_rawf(writer, "\"fps\": %.2f,\n", fps);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_rawf(writer, "\"frame_time_p50_ms\": %.3f,\n", p50 / 1000.0);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_rawf(writer, "\"frame_time_p99_ms\": %.3f,\n", p99 / 1000.0);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_add_string(writer, "counters");
+      rjsonwriter_raw(writer, ": {", 3);
+
+      for (i = 0; i < num_counters; i++)
+      {
+         double total_ms = 0.0;
+
+         if (ticks_per_usec > 0.0)
+            total_ms = (double)counters[i]->total / ticks_per_usec / 1000.0;
+
+         rjsonwriter_raw(writer, (i == 0) ? "\n" : ",\n", (i == 0) ? 1 : 2);
+         rjsonwriter_add_spaces(writer, 4);
+         rjsonwriter_add_string(writer, counters[i]->ident);
+         rjsonwriter_rawf(writer,
+               ": { \"calls\": %llu, \"total_ms\": %.3f, \"share\": %.2f }",
+               (unsigned long long)counters[i]->call_cnt,
+               total_ms,
+               (elapsed > 0) ? total_ms * 100000.0 / elapsed : 0.0);
+      }
+
+      rjsonwriter_raw(writer, "\n", 1);
+      rjsonwriter_add_spaces(writer, 2);
+      rjsonwriter_raw(writer, "}\n}\n", 4);
+      rjsonwriter_free(writer);
+      fflush(stdout);
+   }
+
+   free(bench_st->frame_times);
+   memset(bench_st, 0, sizeof(*bench_st));
+}
@@ -0,0 +1,95 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2023 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BENCHMARK_H
+#define __BENCHMARK_H
+
+#include <stdint.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+#include <libretro.h>
+
+#include "configuration.h"
+
+RETRO_BEGIN_DECLS
+
+#define BENCHMARK_DEFAULT_FRAMES 3000
+
+enum benchmark_flags
+{
+   BENCHMARK_FLAG_ACTIVE       = (1 << 0),
+   /* Don't replace the configured drivers with null drivers */
+   BENCHMARK_FLAG_KEEP_DRIVERS = (1 << 1)
+};
+
+typedef struct benchmark_state
+{
+   retro_time_t *frame_times;      /* duration of each frame, in usec */
+   retro_time_t start_time;
+   retro_time_t last_time;
+   retro_perf_tick_t start_ticks;
+   unsigned max_frames;
+   unsigned num_frames;
+   uint8_t flags;
+} benchmark_state_t;
+
+benchmark_state_t *benchmark_state_get_ptr(void);
+
+/**
+ * benchmark_init:
+ * @frames             : number of frames to run.
+ * @keep_drivers       : if false, null video/audio/input
+ *                       drivers are forced.
+ *
+ * Enables benchmark mode. Must be called while parsing
+ * the command line, before drivers are initialized.
+ *
+ * Returns: true on success.
+ **/
+bool benchmark_init(unsigned frames, bool keep_drivers);
+
+/**
+ * benchmark_apply_settings:
+ * @settings           : current settings.
+ *
+ * Overrides the settings that would otherwise throttle
+ * emulation (vsync, audio sync, frame delay, frame rest),
+ * selects the null drivers if requested and makes sure
+ * none of this is written back to the config file.
+ **/
+void benchmark_apply_settings(settings_t *settings);
+
+/**
+ * benchmark_frame:
+ *
+ * Records the time taken by the previous frame.
+ * Called once per runloop iteration that ran the core.
+ **/
+void benchmark_frame(void);
+
+/**
+ * benchmark_report:
+ *
+ * Prints a JSON report with the frame rate, frame time
+ * percentiles and the time spent in each frontend
+ * performance counter to stdout, then releases all
+ * benchmark state.
+ **/
+void benchmark_report(void);
+
+RETRO_END_DECLS
+
+#endif
@@ -90,6 +90,7 @@ static rcheevos_locals_t rcheevos_locals =
    {0},  /* game */
 #endif
    {{0}},/* memory */
+   {0},  /* memref_table */
 #ifdef HAVE_THREADS
    CMD_EVENT_NONE, /* queued_command */
    false, /* game_placard_requested */
@@ -203,6 +204,117 @@ static void rcheevos_get_core_memory_info(uint32_t id,
    }
 }
 
+/*****************************************************************************
+Memref address table.
+*****************************************************************************/
+
+#define RCHEEVOS_MEMREF_TABLE_MIN_CAPACITY 256
+#define RCHEEVOS_MEMREF_HASH(address) ((uint32_t)((address) * 2654435761U))
+
+static void rcheevos_memref_table_reset(rcheevos_memref_table_t* table)
+{
+   if (table->entries)
+      memset(table->entries, 0, table->capacity * sizeof(*table->entries));
+   table->count = 0;
+}
+
+static void rcheevos_memref_table_free(rcheevos_memref_table_t* table)
+{
+   if (table->entries)
+      free(table->entries);
+   table->entries  = NULL;
+   table->capacity = 0;
+   table->count    = 0;
+}
+
+static bool rcheevos_memref_table_grow(rcheevos_memref_table_t* table)
+{
+   uint32_t i;
+   uint32_t capacity = table->capacity
+      ? table->capacity * 2
+      : RCHEEVOS_MEMREF_TABLE_MIN_CAPACITY;
+   rcheevos_memref_entry_t* entries = (rcheevos_memref_entry_t*)
+      calloc(capacity, sizeof(*entries));
+
+   if (!entries)
+      return false;
+
+   for (i = 0; i < table->capacity; i++)
+   {
+      const rcheevos_memref_entry_t* entry = &table->entries[i];
+      uint32_t slot;
+
+      if (!entry->data)
+         continue;
+
+      slot = RCHEEVOS_MEMREF_HASH(entry->address) & (capacity - 1);
+      while (entries[slot].data)
+         slot = (slot + 1) & (capacity - 1);
+      entries[slot] = *entry;
+   }
+
+   if (table->entries)
+      free(table->entries);
+   table->entries  = entries;
+   table->capacity = capacity;
+   return true;
+}
+
+/* Returns the host pointer for an achievement address and the
+ * number of contiguous bytes available from it. Addresses are
+ * resolved against the region list only the first time they are
+ * seen after the memory map was (re)initialized. */
+static uint8_t* rcheevos_memref_resolve(uint32_t address, uint32_t* avail)
+{
+   rcheevos_memref_table_t* table = &rcheevos_locals.memref_table;
+   rcheevos_memref_entry_t* entry;
+   uint8_t* data;
+   uint32_t mask;
+   uint32_t slot;
+
+   if (table->capacity)
+   {
+      mask = table->capacity - 1;
+      slot = RCHEEVOS_MEMREF_HASH(address) & mask;
+
+      while ((entry = &table->entries[slot])->data)
+      {
+         if (entry->address == address)
+         {
+            *avail = entry->avail;
+            return entry->data;
+         }
+         slot = (slot + 1) & mask;
+      }
+   }
+
+   data = rc_libretro_memory_find_avail(
+         &rcheevos_locals.memory, address, avail);
+
+   /* Don't cache unmapped addresses, the runtime disables
+    * whatever references them */
+   if (!data)
+      return NULL;
+
+   /* Keep the load factor at or below one half */
+   if ((table->count + 1) * 2 > table->capacity)
+      if (!rcheevos_memref_table_grow(table))
+         return data;
+
+   mask = table->capacity - 1;
+   slot = RCHEEVOS_MEMREF_HASH(address) & mask;
+   while (table->entries[slot].data)
+      slot = (slot + 1) & mask;
+
+   entry          = &table->entries[slot];
+   entry->data    = data;
+   entry->address = address;
+   entry->avail   = *avail;
+   table->count++;
+
+   return data;
+}
+
 static int rcheevos_init_memory(rcheevos_locals_t* locals)
 {
    unsigned i;
@@ -241,6 +353,9 @@ static int rcheevos_init_memory(rcheevos_locals_t* locals)
    result = rc_libretro_memory_init(&locals->memory, &mmap,
          rcheevos_get_core_memory_info, console_id);
 
+   /* Any previously resolved pointers may be stale now */
+   rcheevos_memref_table_reset(&locals->memref_table);
+
    free(descriptors);
    return result;
 }
@@ -260,8 +375,7 @@ static uint32_t rcheevos_peek(uint32_t address,
       uint32_t num_bytes, void* ud)
 {
    uint32_t avail;
-   uint8_t* data = rc_libretro_memory_find_avail(
-         &rcheevos_locals.memory, address, &avail);
+   uint8_t* data = rcheevos_memref_resolve(address, &avail);
 
    if (data && avail >= num_bytes)
    {
@@ -1305,6 +1419,7 @@ bool rcheevos_unload(void)
 
    if (rcheevos_locals.memory.count > 0)
       rc_libretro_memory_destroy(&rcheevos_locals.memory);
+   rcheevos_memref_table_free(&rcheevos_locals.memref_table);
 
    if (was_loaded)
    {
@@ -1978,7 +2093,7 @@ static void rcheevos_validate_memrefs(rcheevos_locals_t* locals)
 /*****************************************************************************
 Test all the achievements (call once per frame).
 *****************************************************************************/
-void rcheevos_test(void)
+static void rcheevos_test_frame(void)
 {
 #ifdef HAVE_THREADS
    if (rcheevos_locals.queued_command != CMD_EVENT_NONE)
@@ -2049,6 +2164,19 @@ void rcheevos_test(void)
 #endif /* HAVE_RC_CLIENT */
 }
 
+void rcheevos_test(void)
+{
+   static struct retro_perf_counter rcheevos_test_perf = {0};
+   runloop_state_t *runloop_st = runloop_state_get_ptr();
+
+   performance_counter_init(rcheevos_test_perf, "rcheevos_test");
+   performance_counter_start_plus(runloop_st->perfcnt_enable,
+         rcheevos_test_perf);
+   rcheevos_test_frame();
+   performance_counter_stop_plus(runloop_st->perfcnt_enable,
+         rcheevos_test_perf);
+}
+
 void rcheevos_idle(void)
 {
 #ifdef HAVE_RC_CLIENT
@@ -2382,6 +2510,33 @@ static void rcheevos_show_game_placard(void)
 static uint32_t rcheevos_client_read_memory(uint32_t address,
    uint8_t* buffer, uint32_t num_bytes, rc_client_t* client)
 {
+   uint32_t avail;
+   uint8_t* data = rcheevos_memref_resolve(address, &avail);
+
+   if (data && avail >= num_bytes)
+   {
+      switch (num_bytes)
+      {
+         case 4:
+            buffer[3] = data[3];
+            /* fall-through */
+         case 3:
+            buffer[2] = data[2];
+            /* fall-through */
+         case 2:
+            buffer[1] = data[1];
+            /* fall-through */
+         case 1:
+            buffer[0] = data[0];
+            break;
+         default:
+            memcpy(buffer, data, num_bytes);
+            break;
+      }
+      return num_bytes;
+   }
+
+   /* Read spans multiple regions (or is unmapped) */
    return rc_libretro_memory_read(&rcheevos_locals.memory, address, buffer, num_bytes);
 }
 
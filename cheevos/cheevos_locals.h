@@ -131,6 +131,25 @@ enum rcheevos_summary_notif
    RCHEEVOS_SUMMARY_LAST
 };
 
+/* A resolved memref address. Entries with a NULL data
+ * pointer are free slots. */
+typedef struct rcheevos_memref_entry_t
+{
+   uint8_t* data;
+   uint32_t address;
+   uint32_t avail;
+} rcheevos_memref_entry_t;
+
+/* Open addressing table mapping achievement addresses to host
+ * pointers, so the per-frame reads don't have to walk the region
+ * list. Cleared whenever the memory regions are (re)initialized. */
+typedef struct rcheevos_memref_table_t
+{
+   rcheevos_memref_entry_t* entries;
+   uint32_t capacity;                 /* always a power of two */
+   uint32_t count;
+} rcheevos_memref_table_t;
+
 #ifndef HAVE_RC_CLIENT
 
 typedef struct rcheevos_load_info_t
@@ -198,6 +217,7 @@ typedef struct rcheevos_locals_t
    rcheevos_game_info_t game;         /* information about the current game */
 #endif
    rc_libretro_memory_regions_t memory;/* achievement addresses to core memory mappings */
+   rcheevos_memref_table_t memref_table;/* resolved addresses for the regions in memory */
 
 #ifdef HAVE_THREADS
    enum event_command queued_command; /* action queued by background thread to be run on main thread */
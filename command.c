@@ -63,6 +63,7 @@
 #include "paths.h"
 #include "retroarch.h"
 #include "runloop.h"
+#include "trace.h"
 #include "verbosity.h"
 #include "version.h"
 #include "version_git.h"
@@ -828,6 +829,15 @@ bool command_version(command_t *cmd, const char* arg)
    return true;
 }
 
+bool command_trace_dump(command_t *cmd, const char* arg)
+{
+   /* Written to the path given with --trace */
+   bool ret          = trace_dump(NULL);
+   const char *reply = ret ? "TRACE_DUMP OK\n" : "TRACE_DUMP -1\n";
+   cmd->replier(cmd, reply, strlen(reply));
+   return ret;
+}
+
 static const rarch_memory_descriptor_t* command_memory_get_descriptor(const rarch_memory_map_t* mmap, unsigned address, size_t* offset)
 {
    const rarch_memory_descriptor_t* desc = mmap->descriptors;
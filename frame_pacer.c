@@ -0,0 +1,185 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2023 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <retro_timers.h>
+#include <features/features_cpu.h>
+
+#if defined(__linux__) && !defined(EMSCRIPTEN)
+#include <errno.h>
+#include <time.h>
+#if defined(CLOCK_MONOTONIC) && defined(TIMER_ABSTIME)
+#define FRAME_PACER_HAVE_ABSTIME
+#endif
+#endif
+
+/* Platforms where burning a little CPU at the end of
+ * a wait is acceptable. Everything else only sleeps. */
+#if !defined(EMSCRIPTEN) && ((defined(_WIN32) && !defined(_XBOX)) || defined(__linux__) || (defined(__APPLE__) && !defined(IOS)) || defined(BSD))
+#define FRAME_PACER_CAN_SPIN
+#endif
+
+#include "frame_pacer.h"
+
+/* Bounds for the spin tail, in microseconds */
+#define FRAME_PACER_MIN_SPIN_USEC 50
+#define FRAME_PACER_MAX_SPIN_USEC 2000
+
+static frame_pacer_t frame_pacer_st;
+
+frame_pacer_t *frame_pacer_get_ptr(void)
+{
+   return &frame_pacer_st;
+}
+
+static void frame_pacer_os_sleep_until(retro_time_t target, retro_time_t now)
+{
+#ifdef FRAME_PACER_HAVE_ABSTIME
+   /* cpu_features_get_time_usec() is CLOCK_MONOTONIC on Linux */
+   struct timespec ts;
+   ts.tv_sec  = (time_t)(target / 1000000);
+   ts.tv_nsec = (long)((target % 1000000) * 1000);
+   while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+#else
+   retro_time_t sleep_ms = (target - now) / 1000;
+   if (sleep_ms > 0)
+      retro_sleep((unsigned)sleep_ms);
+#endif
+}
+
+static void frame_pacer_record(frame_pacer_t *pacer, retro_time_t jitter)
+{
+   enum frame_pacer_bucket bucket;
+
+   if (jitter < 0)
+      bucket = FRAME_PACER_BUCKET_EARLY;
+   else if (jitter < 50)
+      bucket = FRAME_PACER_BUCKET_50US;
+   else if (jitter < 100)
+      bucket = FRAME_PACER_BUCKET_100US;
+   else if (jitter < 250)
+      bucket = FRAME_PACER_BUCKET_250US;
+   else if (jitter < 500)
+      bucket = FRAME_PACER_BUCKET_500US;
+   else if (jitter < 1000)
+      bucket = FRAME_PACER_BUCKET_1MS;
+   else if (jitter < 2000)
+      bucket = FRAME_PACER_BUCKET_2MS;
+   else
+      bucket = FRAME_PACER_BUCKET_LATE;
+
+   pacer->histogram[bucket]++;
+   pacer->samples++;
+
+   if (jitter > pacer->max_jitter_usec)
+      pacer->max_jitter_usec = jitter;
+}
+
+retro_time_t frame_pacer_sleep_until(retro_time_t deadline, bool spin)
+{
+   frame_pacer_t *pacer = &frame_pacer_st;
+   retro_time_t now     = cpu_features_get_time_usec();
+   retro_time_t target  = deadline;
+
+   if (deadline <= now)
+      return now;
+
+#ifdef FRAME_PACER_CAN_SPIN
+   /* Wake up early enough to absorb the usual
+    * scheduler lateness, then spin the rest */
+   if (spin)
+   {
+      retro_time_t tail = pacer->oversleep_usec * 2
+         + FRAME_PACER_MIN_SPIN_USEC;
+      if (tail > FRAME_PACER_MAX_SPIN_USEC)
+         tail = FRAME_PACER_MAX_SPIN_USEC;
+      target -= tail;
+   }
+#endif
+
+   if (target > now)
+   {
+      retro_time_t woke;
+      frame_pacer_os_sleep_until(target, now);
+      woke  = cpu_features_get_time_usec();
+      /* Moving average of the OS wake-up lateness */
+      pacer->oversleep_usec += ((woke > target ? woke - target : 0)
+            - pacer->oversleep_usec) / 8;
+      now   = woke;
+   }
+
+#ifdef FRAME_PACER_CAN_SPIN
+   if (spin)
+      while (now < deadline)
+         now = cpu_features_get_time_usec();
+#endif
+
+   frame_pacer_record(pacer, now - deadline);
+   return now;
+}
+
+void frame_pacer_sleep_usec(retro_time_t usec, bool spin)
+{
+   frame_pacer_sleep_until(cpu_features_get_time_usec() + usec, spin);
+}
+
+void frame_pacer_reset_stats(void)
+{
+   frame_pacer_t *pacer = &frame_pacer_st;
+   memset(pacer->histogram, 0, sizeof(pacer->histogram));
+   pacer->samples         = 0;
+   pacer->max_jitter_usec = 0;
+}
+
+size_t frame_pacer_get_stats(char *s, size_t len)
+{
+   int _len;
+   const frame_pacer_t *pacer = &frame_pacer_st;
+   const uint64_t *hist       = pacer->histogram;
+   float scale;
+
+   if (!pacer->samples)
+      return 0;
+
+   scale = 100.0f / (float)pacer->samples;
+
+   /* TODO/FIXME - localize */
+   _len  = snprintf(s, len,
+         " Pacing Jitter:\n"
+         " - Early:     %5.2f %%\n"
+         " - < 100 us:  %5.2f %%\n"
+         " - < 1 ms:    %5.2f %%\n"
+         " - >= 1 ms:   %5.2f %%\n"
+         " - Max:       %5d us\n",
+         hist[FRAME_PACER_BUCKET_EARLY] * scale,
+         (hist[FRAME_PACER_BUCKET_50US]
+            + hist[FRAME_PACER_BUCKET_100US]) * scale,
+         (hist[FRAME_PACER_BUCKET_250US]
+            + hist[FRAME_PACER_BUCKET_500US]
+            + hist[FRAME_PACER_BUCKET_1MS]) * scale,
+         (hist[FRAME_PACER_BUCKET_2MS]
+            + hist[FRAME_PACER_BUCKET_LATE]) * scale,
+         (int)pacer->max_jitter_usec);
+
+   if (_len < 0)
+      return 0;
+   return ((size_t)_len < len) ? (size_t)_len : len - 1;
+}
@@ -0,0 +1,96 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2023 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FRAME_PACER_H
+#define __FRAME_PACER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+#include <libretro.h>
+
+RETRO_BEGIN_DECLS
+
+/* Wake-up lateness buckets, in microseconds:
+ * early, <50, <100, <250, <500, <1000, <2000, >=2000 */
+enum frame_pacer_bucket
+{
+   FRAME_PACER_BUCKET_EARLY = 0,
+   FRAME_PACER_BUCKET_50US,
+   FRAME_PACER_BUCKET_100US,
+   FRAME_PACER_BUCKET_250US,
+   FRAME_PACER_BUCKET_500US,
+   FRAME_PACER_BUCKET_1MS,
+   FRAME_PACER_BUCKET_2MS,
+   FRAME_PACER_BUCKET_LATE,
+   FRAME_PACER_BUCKET_LAST
+};
+
+typedef struct frame_pacer
+{
+   uint64_t histogram[FRAME_PACER_BUCKET_LAST];
+   uint64_t samples;
+   /* Running estimate of how late the OS wakes us
+    * up, used to size the spin tail */
+   retro_time_t oversleep_usec;
+   retro_time_t max_jitter_usec;
+} frame_pacer_t;
+
+frame_pacer_t *frame_pacer_get_ptr(void);
+
+/**
+ * frame_pacer_sleep_until:
+ * @deadline           : absolute time in microseconds, on the
+ *                       cpu_features_get_time_usec() clock.
+ * @spin               : finish the wait by spinning, for
+ *                       sub-millisecond precision.
+ *
+ * Sleeps until @deadline. Sleeping against an absolute deadline
+ * instead of a relative duration keeps repeated waits from
+ * accumulating drift. Without @spin the wait never busy-loops,
+ * which is what power saving callers want.
+ *
+ * Returns: the time at which the wait ended.
+ **/
+retro_time_t frame_pacer_sleep_until(retro_time_t deadline, bool spin);
+
+/**
+ * frame_pacer_sleep_usec:
+ * @usec               : duration in microseconds.
+ * @spin               : see frame_pacer_sleep_until().
+ *
+ * Relative convenience wrapper around frame_pacer_sleep_until().
+ **/
+void frame_pacer_sleep_usec(retro_time_t usec, bool spin);
+
+void frame_pacer_reset_stats(void);
+
+/**
+ * frame_pacer_get_stats:
+ * @s                  : output buffer.
+ * @len                : size of @s.
+ *
+ * Formats the wake-up jitter histogram for the
+ * statistics overlay.
+ *
+ * Returns: number of characters written.
+ **/
+size_t frame_pacer_get_stats(char *s, size_t len);
+
+RETRO_END_DECLS
+
+#endif
@@ -732,6 +732,48 @@ static void gl2_raster_font_upload_atlas(gl2_raster_t *font)
    free(tmp);
 }
 
+/* Re-uploads only the part of the atlas that changed
+ * since the last upload. Expects the font texture
+ * to be bound. */
+static void gl2_raster_font_upload_atlas_region(gl2_raster_t *font)
+{
+   unsigned i, j;
+   const struct font_atlas *atlas = font->atlas;
+   unsigned x                     = atlas->dirty_x;
+   unsigned y                     = atlas->dirty_y;
+   unsigned width                 = atlas->dirty_width;
+   unsigned height                = atlas->dirty_height;
+   uint8_t *tmp                   = NULL;
+   uint8_t *dst                   = NULL;
+
+   if (x + width > atlas->width)
+      width  = atlas->width  - x;
+   if (y + height > atlas->height)
+      height = atlas->height - y;
+
+   if (!(tmp = (uint8_t*)malloc(width * height * 2)))
+      return;
+
+   dst = tmp;
+   for (i = 0; i < height; ++i)
+   {
+      const uint8_t *src = &atlas->buffer[(y + i) * atlas->width + x];
+
+      for (j = 0; j < width; ++j)
+      {
+         *dst++ = 0xff;
+         *dst++ = *src++;
+      }
+   }
+
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+   glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+         GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, tmp);
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+   free(tmp);
+}
+
 static void *gl2_raster_font_init(void *data,
       const char *font_path, float font_size,
       bool is_threaded)
@@ -814,7 +856,10 @@ static void gl2_raster_font_draw_vertices(gl2_t *gl,
 {
    if (font->atlas->dirty)
    {
-      gl2_raster_font_upload_atlas(font);
+      if (font->atlas->dirty_width && font->atlas->dirty_height)
+         gl2_raster_font_upload_atlas_region(font);
+      else
+         gl2_raster_font_upload_atlas(font);
       font->atlas->dirty   = false;
    }
 
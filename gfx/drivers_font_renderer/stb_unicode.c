@@ -40,7 +40,17 @@
 
 #define STB_UNICODE_ATLAS_ROWS 16
 #define STB_UNICODE_ATLAS_COLS 16
-#define STB_UNICODE_ATLAS_SIZE (STB_UNICODE_ATLAS_ROWS * STB_UNICODE_ATLAS_COLS)
+#define STB_UNICODE_ATLAS_PAGE_SIZE (STB_UNICODE_ATLAS_ROWS * STB_UNICODE_ATLAS_COLS)
+/* The atlas is made of up to this many pages stacked
+ * vertically. Slots of a page are only handed out once
+ * every slot of the previous pages is in use, and glyphs
+ * are only evicted once all pages are full */
+#define STB_UNICODE_ATLAS_MAX_PAGES 4
+/* Extra pages are not added if they would push the atlas
+ * (and therefore the driver texture) past this height */
+#define STB_UNICODE_ATLAS_MAX_HEIGHT 2048
+/* Must be a power of two */
+#define STB_UNICODE_MAP_SIZE 0x400
 /* Padding is required between each glyph in
  * the atlas to prevent texture bleed when
  * drawing with linear filtering enabled */
@@ -48,22 +58,26 @@
 
 typedef struct stb_unicode_atlas_slot
 {
-   struct stb_unicode_atlas_slot* next;
+   struct stb_unicode_atlas_slot* next;     /* uc_map bucket chain */
+   struct stb_unicode_atlas_slot* lru_prev; /* more recently used */
+   struct stb_unicode_atlas_slot* lru_next; /* less recently used */
    struct font_glyph glyph;      /* unsigned alignment */
    unsigned charcode;
-   unsigned last_used;
 } stb_unicode_atlas_slot_t;
 
 typedef struct
 {
    uint8_t *font_data;
    struct font_atlas atlas;               /* ptr alignment */
-   stb_unicode_atlas_slot_t* uc_map[0x100];
-   stb_unicode_atlas_slot_t atlas_slots[STB_UNICODE_ATLAS_SIZE];
+   stb_unicode_atlas_slot_t* uc_map[STB_UNICODE_MAP_SIZE];
+   stb_unicode_atlas_slot_t* atlas_slots;
+   stb_unicode_atlas_slot_t* lru_head;    /* most recently used */
+   stb_unicode_atlas_slot_t* lru_tail;    /* least recently used */
    stbtt_fontinfo info;                   /* ptr alignment */
    int max_glyph_width;
    int max_glyph_height;
-   unsigned usage_counter;
+   unsigned num_slots;
+   unsigned used_slots;
    float scale_factor;
    struct font_line_metrics line_metrics; /* float alignment */
 } stb_unicode_font_renderer_t;
@@ -79,33 +93,108 @@ static void font_renderer_stb_unicode_free(void *data)
    stb_unicode_font_renderer_t *self = (stb_unicode_font_renderer_t*)data;
 
    free(self->atlas.buffer);
+   free(self->atlas_slots);
    free(self->font_data);
    free(self);
 }
 
+static void font_renderer_stb_unicode_lru_unlink(
+      stb_unicode_font_renderer_t *handle, stb_unicode_atlas_slot_t *slot)
+{
+   if (slot->lru_prev)
+      slot->lru_prev->lru_next = slot->lru_next;
+   else
+      handle->lru_head         = slot->lru_next;
+
+   if (slot->lru_next)
+      slot->lru_next->lru_prev = slot->lru_prev;
+   else
+      handle->lru_tail         = slot->lru_prev;
+
+   slot->lru_prev = NULL;
+   slot->lru_next = NULL;
+}
+
+static void font_renderer_stb_unicode_lru_push(
+      stb_unicode_font_renderer_t *handle, stb_unicode_atlas_slot_t *slot)
+{
+   slot->lru_prev = NULL;
+   slot->lru_next = handle->lru_head;
+
+   if (handle->lru_head)
+      handle->lru_head->lru_prev = slot;
+   else
+      handle->lru_tail           = slot;
+
+   handle->lru_head = slot;
+}
+
 static stb_unicode_atlas_slot_t* font_renderer_stb_unicode_get_slot(stb_unicode_font_renderer_t *handle)
 {
-   int i, map_id;
-   unsigned oldest = 0;
+   unsigned map_id;
+   stb_unicode_atlas_slot_t *oldest = NULL;
 
-   for (i = 1; i < STB_UNICODE_ATLAS_SIZE; i++)
-      if ((handle->usage_counter - handle->atlas_slots[i].last_used) >
-         (handle->usage_counter - handle->atlas_slots[oldest].last_used))
-         oldest = i;
+   /* Hand out unused slots (from the current or the
+    * next page) before evicting anything */
+   if (handle->used_slots < handle->num_slots)
+      return &handle->atlas_slots[handle->used_slots++];
+
+   oldest = handle->lru_tail;
+   font_renderer_stb_unicode_lru_unlink(handle, oldest);
 
    /* remove from map */
-   map_id = handle->atlas_slots[oldest].charcode & 0xFF;
-   if (handle->uc_map[map_id] == &handle->atlas_slots[oldest])
-      handle->uc_map[map_id] = handle->atlas_slots[oldest].next;
+   map_id = oldest->charcode & (STB_UNICODE_MAP_SIZE - 1);
+   if (handle->uc_map[map_id] == oldest)
+      handle->uc_map[map_id] = oldest->next;
    else if (handle->uc_map[map_id])
    {
       stb_unicode_atlas_slot_t* ptr = handle->uc_map[map_id];
-      while (ptr->next && ptr->next != &handle->atlas_slots[oldest])
+      while (ptr->next && ptr->next != oldest)
          ptr = ptr->next;
-      ptr->next = handle->atlas_slots[oldest].next;
+      ptr->next = oldest->next;
    }
 
-   return &handle->atlas_slots[oldest];
+   return oldest;
+}
+
+/* Grows the region of the atlas that needs to be
+ * re-uploaded so that it includes the given glyph */
+static void font_renderer_stb_unicode_mark_dirty(
+      stb_unicode_font_renderer_t *self, const struct font_glyph *glyph)
+{
+   struct font_atlas *atlas = &self->atlas;
+   unsigned x0              = glyph->atlas_offset_x;
+   unsigned y0              = glyph->atlas_offset_y;
+   unsigned x1              = x0 + self->max_glyph_width;
+   unsigned y1              = y0 + self->max_glyph_height;
+
+   if (!atlas->dirty)
+   {
+      atlas->dirty_x      = x0;
+      atlas->dirty_y      = y0;
+      atlas->dirty_width  = x1 - x0;
+      atlas->dirty_height = y1 - y0;
+      atlas->dirty        = true;
+      return;
+   }
+
+   /* Whole atlas already dirty */
+   if (!atlas->dirty_width || !atlas->dirty_height)
+      return;
+
+   if (atlas->dirty_x + atlas->dirty_width > x1)
+      x1 = atlas->dirty_x + atlas->dirty_width;
+   if (atlas->dirty_y + atlas->dirty_height > y1)
+      y1 = atlas->dirty_y + atlas->dirty_height;
+   if (atlas->dirty_x < x0)
+      x0 = atlas->dirty_x;
+   if (atlas->dirty_y < y0)
+      y0 = atlas->dirty_y;
+
+   atlas->dirty_x      = x0;
+   atlas->dirty_y      = y0;
+   atlas->dirty_width  = x1 - x0;
+   atlas->dirty_height = y1 - y0;
 }
 
 static const struct font_glyph *font_renderer_stb_unicode_get_glyph(
@@ -126,14 +215,18 @@ static const struct font_glyph *font_renderer_stb_unicode_get_glyph(
    if (!self)
       return NULL;
 
-   map_id                               = charcode & 0xFF;
+   map_id                               = charcode & (STB_UNICODE_MAP_SIZE - 1);
    atlas_slot                           = self->uc_map[map_id];
 
    while (atlas_slot)
    {
       if (atlas_slot->charcode == charcode)
       {
-         atlas_slot->last_used = self->usage_counter++;
+         if (atlas_slot != self->lru_head)
+         {
+            font_renderer_stb_unicode_lru_unlink(self, atlas_slot);
+            font_renderer_stb_unicode_lru_push(self, atlas_slot);
+         }
          return &atlas_slot->glyph;
       }
       atlas_slot = atlas_slot->next;
@@ -188,8 +281,8 @@ static const struct font_glyph *font_renderer_stb_unicode_get_glyph(
          ? floor((double)glyph_draw_offset_y) 
          : ceil((double)glyph_draw_offset_y));
 
-   self->atlas.dirty                = true;
-   atlas_slot->last_used            = self->usage_counter++;
+   font_renderer_stb_unicode_mark_dirty(self, &atlas_slot->glyph);
+   font_renderer_stb_unicode_lru_push(self, atlas_slot);
    return &atlas_slot->glyph;
 }
 
@@ -197,14 +290,27 @@ static bool font_renderer_stb_unicode_create_atlas(
       stb_unicode_font_renderer_t *self, float font_size)
 {
    unsigned i, x, y;
+   unsigned num_pages             = STB_UNICODE_ATLAS_MAX_PAGES;
+   unsigned page_height           = 0;
    stb_unicode_atlas_slot_t* slot = NULL;
    int max_glyph_size             = (font_size < 0) ? -font_size : font_size;
 
    self->max_glyph_width          = max_glyph_size;
    self->max_glyph_height         = max_glyph_size;
 
+   page_height                    = (self->max_glyph_height + STB_UNICODE_ATLAS_PADDING) * STB_UNICODE_ATLAS_ROWS;
+   while (num_pages > 1 && page_height * num_pages > STB_UNICODE_ATLAS_MAX_HEIGHT)
+      num_pages--;
+
+   self->num_slots                = num_pages * STB_UNICODE_ATLAS_PAGE_SIZE;
+   self->atlas_slots              = (stb_unicode_atlas_slot_t*)calloc(
+         self->num_slots, sizeof(stb_unicode_atlas_slot_t));
+
+   if (!self->atlas_slots)
+      return false;
+
    self->atlas.width              = (self->max_glyph_width  + STB_UNICODE_ATLAS_PADDING) * STB_UNICODE_ATLAS_COLS;
-   self->atlas.height             = (self->max_glyph_height + STB_UNICODE_ATLAS_PADDING) * STB_UNICODE_ATLAS_ROWS;
+   self->atlas.height             = page_height * num_pages;
 
    self->atlas.buffer             = (uint8_t*)calloc(
       self->atlas.width * self->atlas.height, sizeof(uint8_t));
@@ -214,7 +320,7 @@ static bool font_renderer_stb_unicode_create_atlas(
 
    slot = self->atlas_slots;
 
-   for (y = 0; y < STB_UNICODE_ATLAS_ROWS; y++)
+   for (y = 0; y < STB_UNICODE_ATLAS_ROWS * num_pages; y++)
    {
       for (x = 0; x < STB_UNICODE_ATLAS_COLS; x++)
       {
@@ -233,6 +339,11 @@ static bool font_renderer_stb_unicode_create_atlas(
          font_renderer_stb_unicode_get_glyph(self, i);
    }
 
+   /* Everything rendered so far goes up with the
+    * initial (full) upload */
+   self->atlas.dirty_width        = 0;
+   self->atlas.dirty_height       = 0;
+
    return true;
 }
 
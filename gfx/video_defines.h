@@ -284,6 +284,13 @@ struct font_atlas
    uint8_t *buffer; /* Alpha channel. */
    unsigned width;
    unsigned height;
+   /* Region modified since the atlas was last marked
+    * clean. A zero sized region means the whole atlas
+    * has to be uploaded again. */
+   unsigned dirty_x;
+   unsigned dirty_y;
+   unsigned dirty_width;
+   unsigned dirty_height;
    bool dirty;
 };
 
@@ -61,8 +61,11 @@
 #include "../ui/ui_companion_driver.h"
 #include "../driver.h"
 #include "../file_path_special.h"
+#include "../frame_pacer.h"
 #include "../list_special.h"
+#include "../performance_counters.h"
 #include "../retroarch.h"
+#include "../trace.h"
 #include "../verbosity.h"
 
 #define TIME_TO_FPS(last_time, new_time, frames) ((1000000.0f * (frames)) / ((new_time) - (last_time)))
@@ -3434,6 +3437,8 @@ void video_driver_frame(const void *data, unsigned width,
    if (!video_driver_active)
       return;
 
+   TRACE_BEGIN("video_driver_frame");
+
    new_time                      = cpu_features_get_time_usec();
 
    if (data)
@@ -3726,6 +3731,7 @@ void video_driver_frame(const void *data, unsigned width,
 #ifdef HAVE_VIDEO_FILTER
    if (render_frame && data && video_st->state_filter)
    {
+      static struct retro_perf_counter video_filter_perf = {0};
       unsigned output_width                             = 0;
       unsigned output_height                            = 0;
       unsigned output_pitch                             = 0;
@@ -3735,9 +3741,14 @@ void video_driver_frame(const void *data, unsigned width,
 
       output_pitch = (output_width) * video_st->state_out_bpp;
 
+      performance_counter_init(video_filter_perf, "video_filter");
+      performance_counter_start_plus(runloop_st->perfcnt_enable,
+            video_filter_perf);
       rarch_softfilter_process(video_st->state_filter,
             video_st->state_buffer, output_pitch,
             data, width, height, pitch);
+      performance_counter_stop_plus(runloop_st->perfcnt_enable,
+            video_filter_perf);
 
       if (     video_info.post_filter_record
             && recording_st->data
@@ -3812,9 +3823,9 @@ void video_driver_frame(const void *data, unsigned width,
    if (render_frame && video_info.statistics_show)
    {
       audio_statistics_t audio_stats;
-      char throttle_stats[128];
+      char throttle_stats[256];
       char latency_stats[128];
-      char tmp[128];
+      char tmp[256];
       size_t len;
       double stddev                          = 0.0;
       float font_size_scale                  = video_info.font_size / 100;
@@ -3872,6 +3883,8 @@ void video_driver_frame(const void *data, unsigned width,
                video_st->frame_rest,
                (float)video_st->frame_rest_time_count / runloop_st->core_runtime_usec * 100);
 
+      len += frame_pacer_get_stats(tmp + len, sizeof(tmp) - len);
+
       if (len)
       {
          /* TODO/FIXME - localize */
@@ -4047,6 +4060,8 @@ void video_driver_frame(const void *data, unsigned width,
    else if (!video_info.crt_switch_resolution)
 #endif
       video_st->flags          &= ~VIDEO_FLAG_CRT_SWITCHING_ACTIVE;
+
+   TRACE_END("video_driver_frame");
 }
 
 static void video_driver_reinit_context(settings_t *settings, int flags)
@@ -4173,7 +4188,7 @@ void video_frame_delay(video_driver_state_t *video_st,
 
    /* Never apply frame delay when slow+fastmotion/pause is active */
    if (video_frame_delay_effective > 0 && !skip_delay)
-      retro_sleep(video_frame_delay_effective);
+      frame_pacer_sleep_usec(video_frame_delay_effective * 1000, true);
 }
 
 void video_frame_delay_auto(video_driver_state_t *video_st, video_frame_delay_auto_t *vfda)
@@ -4473,6 +4488,7 @@ void video_frame_rest(video_driver_state_t *video_st,
    {
       if (!menu_is_pausing)
          video_st->frame_rest_time_count += video_st->frame_rest * 1000;
-      retro_sleep(video_st->frame_rest);
+      /* Resting is about saving power, so never spin */
+      frame_pacer_sleep_usec(video_st->frame_rest * 1000, false);
    }
 }
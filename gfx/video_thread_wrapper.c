@@ -29,6 +29,7 @@
 
 #include "../retroarch.h"
 #include "../runloop.h"
+#include "../trace.h"
 #include "../verbosity.h"
 
 static void *video_thread_init_never_call(const video_info_t *video,
@@ -461,11 +462,13 @@ static void video_thread_loop(void *data)
                 * rid of this */
                video_driver_build_info(&video_info);
 
+               TRACE_BEGIN("video_thread_frame");
                ret = thr->driver->frame(thr->driver_data,
                   thr->frame.buffer, thr->frame.width, thr->frame.height,
                   thr->frame.count, thr->frame.pitch,
                   *thr->frame.msg ? thr->frame.msg : NULL,
                   &video_info);
+               TRACE_END("video_thread_frame");
 
                slock_unlock(thr->frame.lock);
 
@@ -178,6 +178,17 @@ CONTENT METADATA RECORDS
 #include "../runtime_file.c"
 #include "../disk_index_file.c"
 
+/*============================================================
+FRAME PACING
+============================================================ */
+#include "../frame_pacer.c"
+
+/*============================================================
+BENCHMARK
+============================================================ */
+#include "../benchmark.c"
+#include "../trace.c"
+
 /*============================================================
 ACHIEVEMENTS
 ============================================================ */
@@ -34,6 +34,11 @@ RETRO_BEGIN_DECLS
 struct http_t;
 struct http_connection_t;
 
+/* Receives a piece of a streamed response body.
+ * Returning false aborts the transfer. */
+typedef bool (*net_http_write_cb_t)(void *user_data,
+      const void *data, size_t len);
+
 struct http_connection_t *net_http_connection_new(const char *url, const char *method, const char *data);
 
 /**
@@ -58,8 +63,28 @@ const char *net_http_connection_url(struct http_connection_t *conn);
 
 const char* net_http_connection_method(struct http_connection_t* conn);
 
+/**
+ * net_http_new:
+ *
+ * Sends the request, on an idle connection to the same
+ * host if the pool has one.
+ *
+ * @return the transfer state, or NULL if the request
+ * could not be sent.
+ **/
 struct http_t *net_http_new(struct http_connection_t *conn);
 
+/**
+ * net_http_set_write_cb:
+ *
+ * Hands the body of a successful (20x) response to @cb as it
+ * arrives instead of keeping it in memory. Must be set before
+ * the first net_http_update(). net_http_data() then returns
+ * NULL; error pages are still kept in memory.
+ **/
+void net_http_set_write_cb(struct http_t *state,
+      net_http_write_cb_t cb, void *user_data);
+
 /**
  * net_http_fd:
  *
@@ -121,10 +146,26 @@ uint8_t* net_http_data(struct http_t *state, size_t* len, bool accept_error);
 /**
  * net_http_delete:
  *
- * Cleans up all memory.
+ * Cleans up all memory. The connection goes back to the pool
+ * if the response was complete and the server keeps it open.
  **/
 void net_http_delete(struct http_t *state);
 
+/**
+ * net_http_pool_set_limit:
+ *
+ * Sets how many idle connections are kept per host.
+ * 0 disables keep-alive and closes all idle connections.
+ **/
+void net_http_pool_set_limit(unsigned per_host);
+
+/**
+ * net_http_pool_clear:
+ *
+ * Closes all idle connections.
+ **/
+void net_http_pool_clear(void);
+
 /**
  * net_http_urlencode:
  *
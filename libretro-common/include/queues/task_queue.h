@@ -77,6 +77,14 @@ typedef void (*retro_task_queue_msg_t)(retro_task_t *task,
 /** @copydoc task_retriever_data::func */
 typedef bool (*retro_task_retriever_t)(retro_task_t *task, void *data);
 
+/**
+ * Called right before and right after a task's handler runs,
+ * on whichever thread runs it.
+ *
+ * @see task_queue_set_trace_cb
+ */
+typedef void (*retro_task_queue_trace_t)(retro_task_t *task, bool begin);
+
 /**
  * Called by \c task_queue_wait after each task executes
  * (i.e. once per pass over the queue).
@@ -603,6 +611,15 @@ void task_queue_set_threaded(void);
  */
 void task_queue_unset_threaded(void);
 
+/**
+ * Sets the function called around each run of a task's handler,
+ * for profiling purposes.
+ *
+ * @param cb The function to call, or \c NULL to disable.
+ * Must be thread-safe if the task queue is threaded.
+ */
+void task_queue_set_trace_cb(retro_task_queue_trace_t cb);
+
 /**
  * Returns whether the task queue is running in threaded mode.
  *
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <time.h>
 
 #include <net/net_http.h>
 #include <net/net_compat.h>
@@ -36,6 +37,18 @@
 #include <lists/string_list.h>
 #include <retro_common_api.h>
 #include <retro_miscellaneous.h>
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+/* Idle connections kept for reuse, over all hosts */
+#define NET_HTTP_POOL_SIZE          16
+/* Default limit of idle connections per host */
+#define NET_HTTP_POOL_PER_HOST      4
+/* Servers usually drop idle connections after 5-15s */
+#define NET_HTTP_POOL_IDLE_SECS     10
+/* Streamed bodies are handed out in pieces of this size */
+#define NET_HTTP_WRITE_SIZE         (64 * 1024)
 
 enum
 {
@@ -64,15 +77,34 @@ struct http_socket_state_t
 struct http_t
 {
    char *data;
+   char *domain;                 /* pool key */
+   char *request;                /* kept until the reply starts,
+                                    in case a reused connection died */
+   void *write_cb_data;
+   net_http_write_cb_t write_cb;
    struct string_list *headers;
    struct http_socket_state_t sock_state; /* ptr alignment */
    size_t pos;
    size_t len;
    size_t buflen;
+   size_t request_len;
+   size_t written;               /* body bytes passed to write_cb */
    int status;
+   int port;
    char part;
    char bodytype;
    bool error;
+   bool keep_alive;
+   bool reused;
+   bool streaming;
+};
+
+struct http_pool_entry
+{
+   char *domain;
+   struct http_socket_state_t sock_state; /* ptr alignment */
+   time_t idle_since;
+   int port;
 };
 
 struct http_connection_t
@@ -91,6 +123,14 @@ struct http_connection_t
    int port;
 };
 
+static struct http_pool_entry net_http_pool[NET_HTTP_POOL_SIZE];
+static unsigned net_http_pool_per_host = NET_HTTP_POOL_PER_HOST;
+#ifdef HAVE_THREADS
+/* Created by the first request, which is assumed
+ * not to race with another one */
+static slock_t *net_http_pool_lock     = NULL;
+#endif
+
 /**
  * net_http_urlencode:
  *
@@ -425,18 +465,19 @@ void net_http_urlencode_full(char *dest,
    free(tmp);
 }
 
-static int net_http_new_socket(struct http_connection_t *conn)
+static int net_http_new_socket(struct http_socket_state_t *sock_state,
+      const char *domain, int port)
 {
    struct addrinfo *addr = NULL, *next_addr = NULL;
    int fd                = socket_init(
-         (void**)&addr, conn->port, conn->domain, SOCKET_TYPE_STREAM, 0);
+         (void**)&addr, port, domain, SOCKET_TYPE_STREAM, 0);
 #ifdef HAVE_SSL
-   if (conn->sock_state.ssl)
+   if (sock_state->ssl)
    {
       if (fd < 0)
          goto done;
 
-      if (!(conn->sock_state.ssl_ctx = ssl_socket_init(fd, conn->domain)))
+      if (!(sock_state->ssl_ctx = ssl_socket_init(fd, domain)))
       {
          socket_close(fd);
          fd = -1;
@@ -450,11 +491,11 @@ static int net_http_new_socket(struct http_connection_t *conn)
       /* Temp fix, don't use new timeout/poll code for cheevos http requests */
          bool timeout = true;
 #ifdef __WIN32
-      if (!strcmp(conn->domain, "retroachievements.org"))
+      if (!strcmp(domain, "retroachievements.org"))
          timeout = false;
 #endif
 
-      if (ssl_socket_connect(conn->sock_state.ssl_ctx, addr, timeout, true)
+      if (ssl_socket_connect(sock_state->ssl_ctx, addr, timeout, true)
             < 0)
       {
          fd = -1;
@@ -477,31 +518,246 @@ done:
    if (addr)
       freeaddrinfo_retro(addr);
 
-   conn->sock_state.fd = fd;
+   sock_state->fd = fd;
 
    return fd;
 }
 
-static void net_http_send_str(
-      struct http_socket_state_t *sock_state, bool *error,
-      const char *text, size_t text_size)
+static void net_http_close_socket(struct http_socket_state_t *sock_state)
 {
-   if (*error)
-      return;
 #ifdef HAVE_SSL
-   if (sock_state->ssl)
+   if (sock_state->ssl && sock_state->ssl_ctx)
    {
-      if (!ssl_socket_send_all_blocking(
-               sock_state->ssl_ctx, text, text_size, true))
-         *error = true;
+      ssl_socket_close(sock_state->ssl_ctx);
+      ssl_socket_free(sock_state->ssl_ctx);
+      sock_state->ssl_ctx = NULL;
    }
    else
 #endif
+   if (sock_state->fd >= 0)
+      socket_close(sock_state->fd);
+   sock_state->fd = -1;
+}
+
+/* An idle connection has nothing to say. If it's readable,
+ * the server closed it or sent something unexpected. */
+static bool net_http_socket_is_alive(struct http_socket_state_t *sock_state)
+{
+   bool rd = true;
+   if (!socket_wait(sock_state->fd, &rd, NULL, 0))
+      return false;
+   return !rd;
+}
+
+static void net_http_pool_lock_acquire(void)
+{
+#ifdef HAVE_THREADS
+   if (!net_http_pool_lock)
+      net_http_pool_lock = slock_new();
+   if (net_http_pool_lock)
+      slock_lock(net_http_pool_lock);
+#endif
+}
+
+static void net_http_pool_lock_release(void)
+{
+#ifdef HAVE_THREADS
+   if (net_http_pool_lock)
+      slock_unlock(net_http_pool_lock);
+#endif
+}
+
+/* Takes an idle connection to the same host out of the pool */
+static bool net_http_pool_acquire(struct http_socket_state_t *sock_state,
+      const char *domain, int port)
+{
+   for (;;)
    {
-      if (!socket_send_all_blocking(
-               sock_state->fd, text, text_size, true))
+      unsigned i;
+      struct http_socket_state_t found;
+      time_t idle_since = 0;
+      bool have_found   = false;
+
+      net_http_pool_lock_acquire();
+      for (i = 0; i < NET_HTTP_POOL_SIZE; i++)
+      {
+         struct http_pool_entry *entry = &net_http_pool[i];
+         if (     entry->domain
+               && entry->port           == port
+               && entry->sock_state.ssl == sock_state->ssl
+               && string_is_equal(entry->domain, domain))
+         {
+            found         = entry->sock_state;
+            idle_since    = entry->idle_since;
+            have_found    = true;
+            free(entry->domain);
+            entry->domain = NULL;
+            break;
+         }
+      }
+      net_http_pool_lock_release();
+
+      if (!have_found)
+         return false;
+
+      if (     time(NULL) - idle_since < NET_HTTP_POOL_IDLE_SECS
+            && net_http_socket_is_alive(&found))
+      {
+         *sock_state = found;
+         return true;
+      }
+
+      net_http_close_socket(&found);
+   }
+}
+
+/* Hands the connection of a finished response back to the pool.
+ * Returns false if it must be closed instead. */
+static bool net_http_pool_release(struct http_t *state)
+{
+   unsigned i;
+   unsigned same_host               = 0;
+   struct http_pool_entry *slot     = NULL;
+   struct http_pool_entry *oldest   = NULL;
+   struct http_socket_state_t evict;
+   char *domain                     = NULL;
+
+   if (     !state->keep_alive
+         ||  state->error
+         ||  state->part     != P_DONE
+         ||  state->bodytype == T_FULL
+         || !state->domain)
+      return false;
+
+   if (!(domain = strdup(state->domain)))
+      return false;
+
+   evict.fd      = -1;
+   evict.ssl     = false;
+   evict.ssl_ctx = NULL;
+
+   net_http_pool_lock_acquire();
+   for (i = 0; i < NET_HTTP_POOL_SIZE; i++)
+   {
+      struct http_pool_entry *entry = &net_http_pool[i];
+      if (!entry->domain)
+      {
+         if (!slot)
+            slot = entry;
+         continue;
+      }
+      if (     entry->port == state->port
+            && string_is_equal(entry->domain, state->domain))
+         same_host++;
+      if (!oldest || entry->idle_since < oldest->idle_since)
+         oldest = entry;
+   }
+
+   if (same_host >= net_http_pool_per_host)
+      slot = NULL;
+   else if (!slot && oldest)
+   {
+      /* Pool is full, make room */
+      evict          = oldest->sock_state;
+      free(oldest->domain);
+      oldest->domain = NULL;
+      slot           = oldest;
+   }
+
+   if (slot)
+   {
+      slot->domain     = domain;
+      slot->sock_state = state->sock_state;
+      slot->port       = state->port;
+      slot->idle_since = time(NULL);
+      domain           = NULL;
+   }
+   net_http_pool_lock_release();
+
+   net_http_close_socket(&evict);
+
+   if (domain)
+   {
+      free(domain);
+      return false;
+   }
+   return true;
+}
+
+void net_http_pool_set_limit(unsigned per_host)
+{
+   net_http_pool_per_host = per_host;
+   if (per_host == 0)
+      net_http_pool_clear();
+}
+
+void net_http_pool_clear(void)
+{
+   unsigned i;
+
+   for (i = 0; i < NET_HTTP_POOL_SIZE; i++)
+   {
+      struct http_socket_state_t sock_state;
+
+      net_http_pool_lock_acquire();
+      if (!net_http_pool[i].domain)
+      {
+         net_http_pool_lock_release();
+         continue;
+      }
+      sock_state               = net_http_pool[i].sock_state;
+      free(net_http_pool[i].domain);
+      net_http_pool[i].domain  = NULL;
+      net_http_pool_lock_release();
+
+      net_http_close_socket(&sock_state);
+   }
+}
+
+static bool net_http_send(struct http_socket_state_t *sock_state,
+      const char *data, size_t len)
+{
+#ifdef HAVE_SSL
+   if (sock_state->ssl)
+      return ssl_socket_send_all_blocking(
+               sock_state->ssl_ctx, data, len, true);
+#endif
+   return socket_send_all_blocking(sock_state->fd, data, len, true);
+}
+
+struct http_request_buf
+{
+   char *data;
+   size_t len;
+   size_t cap;
+};
+
+/* The request is built up front and sent in one go, so it
+ * doesn't get split over many small packets */
+static void net_http_send_str(
+      struct http_request_buf *req, bool *error,
+      const char *text, size_t text_size)
+{
+   if (*error)
+      return;
+
+   if (req->len + text_size > req->cap)
+   {
+      size_t new_cap = req->cap ? req->cap : 512;
+      char *new_data = NULL;
+      while (new_cap < req->len + text_size)
+         new_cap *= 2;
+      if (!(new_data = (char*)realloc(req->data, new_cap)))
+      {
          *error = true;
+         return;
+      }
+      req->data = new_data;
+      req->cap  = new_cap;
    }
+
+   memcpy(req->data + req->len, text, text_size);
+   req->len += text_size;
 }
 
 struct http_connection_t *net_http_connection_new(const char *url,
@@ -740,38 +996,41 @@ const char* net_http_connection_method(struct http_connection_t* conn)
 
 struct http_t *net_http_new(struct http_connection_t *conn)
 {
+   struct http_request_buf req;
    bool error            = false;
-#ifdef HAVE_SSL
-   if (!conn || (net_http_new_socket(conn)) < 0)
-      return NULL;
-#else
-   int fd                = -1;
-   if (!conn || (fd = net_http_new_socket(conn)) < 0)
+   bool reused           = false;
+
+   if (!conn)
       return NULL;
-#endif
+
+   req.data                 = NULL;
+   req.len                  = 0;
+   req.cap                  = 0;
+   conn->sock_state.fd      = -1;
+   conn->sock_state.ssl_ctx = NULL;
 
    /* This is a bit lazy, but it works. */
    if (conn->methodcopy)
    {
-      net_http_send_str(&conn->sock_state, &error, conn->methodcopy,
+      net_http_send_str(&req, &error, conn->methodcopy,
             strlen(conn->methodcopy));
-      net_http_send_str(&conn->sock_state, &error, " /",
+      net_http_send_str(&req, &error, " /",
             STRLEN_CONST(" /"));
    }
    else
    {
-      net_http_send_str(&conn->sock_state, &error, "GET /",
+      net_http_send_str(&req, &error, "GET /",
             STRLEN_CONST("GET /"));
    }
 
-   net_http_send_str(&conn->sock_state, &error, conn->location,
+   net_http_send_str(&req, &error, conn->location,
          strlen(conn->location));
-   net_http_send_str(&conn->sock_state, &error, " HTTP/1.1\r\n",
+   net_http_send_str(&req, &error, " HTTP/1.1\r\n",
          STRLEN_CONST(" HTTP/1.1\r\n"));
 
-   net_http_send_str(&conn->sock_state, &error, "Host: ",
+   net_http_send_str(&req, &error, "Host: ",
          STRLEN_CONST("Host: "));
-   net_http_send_str(&conn->sock_state, &error, conn->domain,
+   net_http_send_str(&req, &error, conn->domain,
          strlen(conn->domain));
 
    if (conn->port)
@@ -782,23 +1041,23 @@ struct http_t *net_http_new(struct http_connection_t *conn)
       portstr[++_len] = '\0';
       _len           += snprintf(portstr + _len, sizeof(portstr) - _len,
             "%i", conn->port);
-      net_http_send_str(&conn->sock_state, &error, portstr, _len);
+      net_http_send_str(&req, &error, portstr, _len);
    }
 
-   net_http_send_str(&conn->sock_state, &error, "\r\n",
+   net_http_send_str(&req, &error, "\r\n",
          STRLEN_CONST("\r\n"));
 
    /* Pre-formatted headers */
    if (conn->headerscopy)
-      net_http_send_str(&conn->sock_state, &error, conn->headerscopy,
+      net_http_send_str(&req, &error, conn->headerscopy,
             strlen(conn->headerscopy));
    if (conn->contenttypecopy)
    {
-      net_http_send_str(&conn->sock_state, &error, "Content-Type: ",
+      net_http_send_str(&req, &error, "Content-Type: ",
             STRLEN_CONST("Content-Type: "));
-      net_http_send_str(&conn->sock_state, &error,
+      net_http_send_str(&req, &error,
             conn->contenttypecopy, strlen(conn->contenttypecopy));
-      net_http_send_str(&conn->sock_state, &error, "\r\n",
+      net_http_send_str(&req, &error, "\r\n",
             STRLEN_CONST("\r\n"));
    }
 
@@ -813,14 +1072,14 @@ struct http_t *net_http_new(struct http_connection_t *conn)
       if (!conn->headerscopy)
       {
          if (!conn->contenttypecopy)
-            net_http_send_str(&conn->sock_state, &error,
+            net_http_send_str(&req, &error,
                   "Content-Type: application/x-www-form-urlencoded\r\n",
                   STRLEN_CONST(
                      "Content-Type: application/x-www-form-urlencoded\r\n"
                      ));
       }
 
-      net_http_send_str(&conn->sock_state, &error, "Content-Length: ",
+      net_http_send_str(&req, &error, "Content-Length: ",
             STRLEN_CONST("Content-Length: "));
 
       post_len = conn->contentlength;
@@ -836,54 +1095,104 @@ struct http_t *net_http_new(struct http_connection_t *conn)
 
       len_str[len] = '\0';
 
-      net_http_send_str(&conn->sock_state, &error, len_str,
+      net_http_send_str(&req, &error, len_str,
             strlen(len_str));
-      net_http_send_str(&conn->sock_state, &error, "\r\n",
+      net_http_send_str(&req, &error, "\r\n",
             STRLEN_CONST("\r\n"));
 
       free(len_str);
    }
 
-   net_http_send_str(&conn->sock_state, &error, "User-Agent: ",
+   net_http_send_str(&req, &error, "User-Agent: ",
          STRLEN_CONST("User-Agent: "));
    if (conn->useragentcopy)
-      net_http_send_str(&conn->sock_state, &error,
+      net_http_send_str(&req, &error,
             conn->useragentcopy, strlen(conn->useragentcopy));
    else
-      net_http_send_str(&conn->sock_state, &error, "libretro",
+      net_http_send_str(&req, &error, "libretro",
             STRLEN_CONST("libretro"));
-   net_http_send_str(&conn->sock_state, &error, "\r\n",
+   net_http_send_str(&req, &error, "\r\n",
          STRLEN_CONST("\r\n"));
 
-   net_http_send_str(&conn->sock_state, &error,
-         "Connection: close\r\n", STRLEN_CONST("Connection: close\r\n"));
-   net_http_send_str(&conn->sock_state, &error, "\r\n",
+   /* HTTP/1.1 connections are persistent unless closed */
+   if (net_http_pool_per_host == 0)
+      net_http_send_str(&req, &error,
+            "Connection: close\r\n", STRLEN_CONST("Connection: close\r\n"));
+   net_http_send_str(&req, &error, "\r\n",
          STRLEN_CONST("\r\n"));
 
    if (conn->postdatacopy && conn->contentlength)
-      net_http_send_str(&conn->sock_state, &error, conn->postdatacopy,
+      net_http_send_str(&req, &error, conn->postdatacopy,
             conn->contentlength);
 
-   if (!error)
+   if (error)
+      goto err;
+
+   if (     net_http_pool_per_host > 0
+         && net_http_pool_acquire(&conn->sock_state, conn->domain, conn->port))
+   {
+      /* A connection may still die between the liveness
+       * check and the send, open a fresh one then */
+      if (net_http_send(&conn->sock_state, req.data, req.len))
+         reused = true;
+      else
+         net_http_close_socket(&conn->sock_state);
+   }
+
+   if (!reused)
+   {
+      if (net_http_new_socket(&conn->sock_state, conn->domain, conn->port) < 0)
+         goto err;
+      if (!net_http_send(&conn->sock_state, req.data, req.len))
+         goto err;
+   }
+
    {
       struct http_t *state = (struct http_t*)malloc(sizeof(struct http_t));
+      if (!state)
+         goto err;
       state->sock_state    = conn->sock_state;
+      state->domain        = strdup(conn->domain);
+      state->port          = conn->port;
+      state->request       = NULL;
+      state->request_len   = 0;
+      state->write_cb      = NULL;
+      state->write_cb_data = NULL;
+      state->written       = 0;
       state->status        = -1;
       state->data          = NULL;
+      state->headers       = NULL;
       state->part          = P_HEADER_TOP;
       state->bodytype      = T_FULL;
       state->error         = false;
+      state->keep_alive    = false;
+      state->reused        = reused;
+      state->streaming     = false;
       state->pos           = 0;
       state->len           = 0;
       state->buflen        = 512;
 
+      /* Only a reused connection may need the request again */
+      if (reused)
+      {
+         state->request     = req.data;
+         state->request_len = req.len;
+         req.data           = NULL;
+      }
+
       if ((state->data = (char*)malloc(state->buflen)))
       {
          if ((state->headers = string_list_new()) &&
              string_list_initialize(state->headers))
+         {
+            free(req.data);
             return state;
+         }
          string_list_free(state->headers);
+         free(state->data);
       }
+      free(state->request);
+      free(state->domain);
       free(state);
    }
 
@@ -900,19 +1209,10 @@ err:
       conn->contenttypecopy      = NULL;
       conn->postdatacopy         = NULL;
 
-#ifdef HAVE_SSL
-      if (conn->sock_state.ssl_ctx)
-      {
-         ssl_socket_close(conn->sock_state.ssl_ctx);
-         ssl_socket_free(conn->sock_state.ssl_ctx);
-         conn->sock_state.ssl_ctx = NULL;
-      }
-#endif
+      net_http_close_socket(&conn->sock_state);
    }
 
-#ifndef HAVE_SSL
-   socket_close(fd);
-#endif
+   free(req.data);
    return NULL;
 }
 
@@ -931,6 +1231,50 @@ int net_http_fd(struct http_t *state)
    return state->sock_state.fd;
 }
 
+void net_http_set_write_cb(struct http_t *state,
+      net_http_write_cb_t cb, void *user_data)
+{
+   if (!state)
+      return;
+   state->write_cb      = cb;
+   state->write_cb_data = user_data;
+}
+
+/* Reconnects and sends the request again. Only done when a
+ * reused connection failed before any reply arrived, as the
+ * server then closed it while idle and never saw the request. */
+static bool net_http_resend(struct http_t *state)
+{
+   bool ok;
+
+   net_http_close_socket(&state->sock_state);
+   state->reused = false;
+   ok            =
+         net_http_new_socket(&state->sock_state,
+            state->domain, state->port) >= 0
+      && net_http_send(&state->sock_state,
+            state->request, state->request_len);
+
+   free(state->request);
+   state->request     = NULL;
+   state->request_len = 0;
+   return ok;
+}
+
+/* Passes the body received so far on to the write callback */
+static bool net_http_write(struct http_t *state)
+{
+   if (state->pos && !state->write_cb(state->write_cb_data,
+            state->data, state->pos))
+   {
+      state->error = true;
+      return false;
+   }
+   state->written += state->pos;
+   state->pos      = 0;
+   return true;
+}
+
 /**
  * net_http_update:
  *
@@ -963,10 +1307,26 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
 
          if (newlen < 0)
          {
+            if (     state->request
+                  && state->part == P_HEADER_TOP
+                  && state->pos  == 0)
+            {
+               state->error = false;
+               if (net_http_resend(state))
+                  return false;
+            }
             state->error  = true;
             goto error;
          }
 
+         /* The reply started, the connection is fine */
+         if (newlen > 0 && state->request)
+         {
+            free(state->request);
+            state->request     = NULL;
+            state->request_len = 0;
+         }
+
          if (state->pos + newlen >= state->buflen - 64)
          {
             state->buflen *= 2;
@@ -997,6 +1357,9 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
                state->status    = (int)strtoul(state->data 
                      + STRLEN_CONST("HTTP/1.1 "), NULL, 10);
                state->part      = P_HEADER;
+               /* Only HTTP/1.1 connections persist by default */
+               state->keep_alive = net_http_pool_per_host > 0
+                  && state->data[STRLEN_CONST("HTTP/1.")] == '1';
             }
             else
             {
@@ -1011,6 +1374,14 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
                }
                if (string_is_equal_case_insensitive(state->data, "Transfer-Encoding: chunked"))
                   state->bodytype = T_CHUNK;
+               if (string_starts_with_case_insensitive(state->data, "Connection:"))
+               {
+                  char* ptr = state->data + STRLEN_CONST("Connection:");
+                  while (ISSPACE(*ptr))
+                     ++ptr;
+                  if (string_is_equal_case_insensitive(ptr, "close"))
+                     state->keep_alive = false;
+               }
 
                if (state->data[0]=='\0')
                {
@@ -1023,6 +1394,10 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
                      state->part = P_BODY;
                      if (state->bodytype == T_CHUNK)
                         state->part = P_BODY_CHUNKLEN;
+                     /* Error pages stay in memory */
+                     state->streaming = state->write_cb
+                        && state->status >= 200
+                        && state->status <= 299;
                   }
                }
                else
@@ -1125,9 +1500,23 @@ parse_again:
                      state->part = P_BODY;
                      if (state->len == 0)
                      {
+                        /* The connection can only be reused if the
+                         * empty trailer after the last chunk is in */
+                        if (     newlen != 2
+                              || memcmp(state->data + state->pos, "\r\n", 2))
+                           state->keep_alive = false;
                         state->part = P_DONE;
-                        state->len  = state->pos;
-                        state->data = (char*)realloc(state->data, state->len);
+                        if (state->streaming)
+                        {
+                           if (!net_http_write(state))
+                              goto error;
+                           state->len  = state->written;
+                        }
+                        else
+                        {
+                           state->len  = state->pos;
+                           state->data = (char*)realloc(state->data, state->len);
+                        }
                      }
                      goto parse_again;
                   }
@@ -1145,27 +1534,38 @@ parse_again:
                }
                state->pos += newlen;
                state->len -= newlen;
+
+               if (     state->streaming
+                     && state->pos >= NET_HTTP_WRITE_SIZE
+                     && !net_http_write(state))
+                  goto error;
             }
          }
          else
          {
             state->pos += newlen;
 
-            if (state->pos > state->len)
+            if (state->written + state->pos > state->len)
             {
                state->error  = true;
                goto error;
             }
-            else if (state->pos == state->len)
+            else if (state->written + state->pos == state->len)
             {
                state->part   = P_DONE;
-               state->data   = (char*)realloc(state->data, state->len);
+               if (!state->streaming)
+                  state->data   = (char*)realloc(state->data, state->len);
             }
+
+            if (     state->streaming
+                  && (state->part == P_DONE || state->pos >= NET_HTTP_WRITE_SIZE)
+                  && !net_http_write(state))
+               goto error;
          }
       }
 
       if (progress)
-         *progress = state->pos;
+         *progress = state->written + state->pos;
 
       if (total)
       {
@@ -1235,7 +1635,9 @@ uint8_t* net_http_data(struct http_t *state, size_t* len, bool accept_error)
    if (!state)
       return NULL;
 
-   if (!accept_error && (state->error || state->status < 200 || state->status > 299))
+   /* Streamed bodies were handed out as they came in */
+   if (     state->streaming
+         || (!accept_error && (state->error || state->status < 200 || state->status > 299)))
    {
       if (len)
          *len = 0;
@@ -1258,19 +1660,14 @@ void net_http_delete(struct http_t *state)
    if (!state)
       return;
 
-   if (state->sock_state.fd >= 0)
-   {
-#ifdef HAVE_SSL
-      if (state->sock_state.ssl && state->sock_state.ssl_ctx)
-      {
-         ssl_socket_close(state->sock_state.ssl_ctx);
-         ssl_socket_free(state->sock_state.ssl_ctx);
-         state->sock_state.ssl_ctx = NULL;
-      }
-      else
-#endif
-      socket_close(state->sock_state.fd);
-   }
+   if (!net_http_pool_release(state))
+      net_http_close_socket(&state->sock_state);
+
+   /* Only the streamed body isn't owned by the caller */
+   if (state->streaming)
+      free(state->data);
+   free(state->request);
+   free(state->domain);
    free(state);
 }
 
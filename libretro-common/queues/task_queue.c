@@ -54,6 +54,7 @@ struct retro_task_impl
 
 /* TODO/FIXME - static globals */
 static retro_task_queue_msg_t msg_push_bak  = NULL;
+static retro_task_queue_trace_t trace_cb     = NULL;
 static task_queue_t tasks_running           = {NULL, NULL};
 static task_queue_t tasks_finished          = {NULL, NULL};
 
@@ -226,7 +227,11 @@ static void retro_task_regular_gather(void)
 
       if (!task->when || task->when < cpu_features_get_time_usec())
       {
+         if (trace_cb)
+            trace_cb(task, true);
          task->handler(task);
+         if (trace_cb)
+            trace_cb(task, false);
 
          task_queue_push_progress(task);
       }
@@ -508,7 +513,11 @@ static void threaded_worker(void *userdata)
 
       slock_unlock(running_lock);
 
+      if (trace_cb)
+         trace_cb(task, true);
       task->handler(task);
+      if (trace_cb)
+         trace_cb(task, false);
 
       slock_lock(property_lock);
       finished = task->finished;
@@ -641,6 +650,11 @@ void task_queue_unset_threaded(void)
    task_threaded_enable = false;
 }
 
+void task_queue_set_trace_cb(retro_task_queue_trace_t cb)
+{
+   trace_cb = cb;
+}
+
 bool task_queue_is_threaded(void)
 {
    return task_threaded_enable;
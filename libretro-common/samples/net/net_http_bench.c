@@ -0,0 +1,177 @@
+/* Copyright  (C) 2010-2023 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (net_http_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Downloads many small files, first with a new connection per
+ * file, then with keep-alive connections. Serve some files
+ * locally with e.g.
+ *
+ *    mkdir files && cd files
+ *    for i in $(seq 0 1999); do head -c 4096 /dev/urandom > $i; done
+ *    python3 -m http.server --protocol HTTP/1.1 8000
+ *
+ * and run
+ *
+ *    ./http_bench http://127.0.0.1:8000/%u 2000 4
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <features/features_cpu.h>
+#include <net/net_http.h>
+#include <net/net_compat.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#endif
+
+#define BENCH_MAX_TRANSFERS 64
+
+struct bench_transfer
+{
+   struct http_t *http;
+   size_t bytes;
+};
+
+static double bench_now_ms(void)
+{
+   return cpu_features_get_time_usec() / 1000.0;
+}
+
+/* Stands in for a file, bodies are only counted */
+static bool bench_write(void *user_data, const void *data, size_t len)
+{
+   ((struct bench_transfer*)user_data)->bytes += len;
+   return true;
+}
+
+static struct http_t *bench_start(const char *url_fmt, unsigned i,
+      struct bench_transfer *transfer)
+{
+   char url[1024];
+   struct http_t *http            = NULL;
+   struct http_connection_t *conn = NULL;
+
+   snprintf(url, sizeof(url), url_fmt, i);
+
+   if (!(conn = net_http_connection_new(url, "GET", NULL)))
+      return NULL;
+
+   while (!net_http_connection_iterate(conn)) {}
+
+   if (net_http_connection_done(conn))
+      http = net_http_new(conn);
+
+   net_http_connection_free(conn);
+
+   if (http)
+      net_http_set_write_cb(http, bench_write, transfer);
+   return http;
+}
+
+static int bench_run(const char *url_fmt, unsigned count,
+      unsigned concurrency, unsigned keep_alive)
+{
+   unsigned i;
+   struct bench_transfer transfers[BENCH_MAX_TRANSFERS];
+   unsigned next     = 0;
+   unsigned done     = 0;
+   unsigned failed   = 0;
+   size_t total      = 0;
+   double start      = bench_now_ms();
+   double elapsed;
+
+   net_http_pool_set_limit(keep_alive);
+   memset(transfers, 0, sizeof(transfers));
+
+   while (done < count)
+   {
+      for (i = 0; i < concurrency; i++)
+      {
+         struct bench_transfer *t = &transfers[i];
+
+         if (!t->http)
+         {
+            if (next >= count)
+               continue;
+            t->bytes = 0;
+            if (!(t->http = bench_start(url_fmt, next++, t)))
+            {
+               failed++;
+               done++;
+               continue;
+            }
+         }
+
+         if (!net_http_update(t->http, NULL, NULL))
+            continue;
+
+         if (net_http_error(t->http))
+            failed++;
+         total += t->bytes;
+         net_http_delete(t->http);
+         t->http = NULL;
+         done++;
+      }
+   }
+
+   elapsed = bench_now_ms() - start;
+   printf("%-11s %u files, %u failed, %lu bytes, %.1f ms, %.1f files/s\n",
+         keep_alive ? "keep-alive:" : "close:",
+         count, failed, (unsigned long)total, elapsed,
+         elapsed > 0.0 ? count * 1000.0 / elapsed : 0.0);
+
+   net_http_pool_clear();
+   return failed ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+   unsigned count       = 2000;
+   unsigned concurrency = 4;
+   int ret              = 0;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <url with %%u for the file number> [count] [concurrent transfers]\n",
+            argv[0]);
+      return 1;
+   }
+
+   if (argc > 2)
+      count = (unsigned)strtoul(argv[2], NULL, 10);
+   if (argc > 3)
+      concurrency = (unsigned)strtoul(argv[3], NULL, 10);
+   if (concurrency < 1)
+      concurrency = 1;
+   if (concurrency > BENCH_MAX_TRANSFERS)
+      concurrency = BENCH_MAX_TRANSFERS;
+
+   if (!network_init())
+      return 1;
+
+   ret |= bench_run(argv[1], count, concurrency, 0);
+   ret |= bench_run(argv[1], count, concurrency, concurrency);
+
+   return ret;
+}
@@ -34,6 +34,13 @@
 #include <retro_endianness.h>
 #include <string/stdstring.h>
 #include <compat/strl.h>
+#include <retro_miscellaneous.h>
+
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "libretrodb.h"
 #include "rmsgpack_dom.h"
@@ -50,24 +57,32 @@ struct node_iter_ctx
    libretrodb_index_t *idx;
 };
 
+struct libretrodb_index
+{
+   char name[50];
+   uint64_t key_size;
+   uint64_t next;
+   uint64_t count;
+   uint64_t offset;           /* start of the sorted key/offset pairs */
+};
+
 struct libretrodb
 {
    RFILE *fd;
    char *path;
+   /* Whole file, only set up for indexed lookups */
+   const uint8_t *map;
+   uint64_t map_size;
+   /* Index headers, parsed once on first lookup */
+   libretrodb_index_t *indexes;
+   unsigned num_indexes;
+   bool map_is_mmap;
    bool can_write;
    uint64_t root;
    uint64_t count;
    uint64_t first_index_offset;
 };
 
-struct libretrodb_index
-{
-   char name[50];
-   uint64_t key_size;
-   uint64_t next;
-   uint64_t count;
-};
-
 typedef struct libretrodb_metadata
 {
    uint64_t count;
@@ -79,13 +94,24 @@ typedef struct libretrodb_header
    uint64_t metadata_offset;
 } libretrodb_header_t;
 
+enum libretrodb_cursor_flags
+{
+   /* Records are filtered in the mapped file */
+   LIBRETRODB_CURSOR_FLAG_RAW     = (1 << 0),
+   /* An index lookup found the only candidate */
+   LIBRETRODB_CURSOR_FLAG_INDEXED = (1 << 1)
+};
+
 struct libretrodb_cursor
 {
    RFILE *fd;
    libretrodb_query_t *query;
    libretrodb_t *db;
+   uint64_t start;            /* first record offset, raw cursors only */
+   uint64_t pos;              /* next record offset, raw cursors only */
    int is_valid;
    int eof;
+   uint8_t flags;
 };
 
 static int libretrodb_validate_document(const struct rmsgpack_dom_value *doc)
@@ -171,8 +197,369 @@ clean:
    return rv;
 }
 
+static void libretrodb_unmap(libretrodb_t *db)
+{
+   if (db->map)
+   {
+#ifdef HAVE_MMAP
+      if (db->map_is_mmap)
+         munmap((void*)db->map, (size_t)db->map_size);
+      else
+#endif
+         free((void*)db->map);
+   }
+   if (db->indexes)
+      free(db->indexes);
+   db->map         = NULL;
+   db->map_size    = 0;
+   db->map_is_mmap = false;
+   db->indexes     = NULL;
+   db->num_indexes = 0;
+}
+
+/* Makes the whole file available in memory, mapped
+ * where possible and read in otherwise */
+static bool libretrodb_map(libretrodb_t *db)
+{
+   int64_t len = 0;
+   void *buf   = NULL;
+
+   if (db->map)
+      return true;
+   if (string_is_empty(db->path))
+      return false;
+
+#ifdef HAVE_MMAP
+   {
+      struct stat st;
+      int fd = open(db->path, O_RDONLY);
+      if (fd >= 0)
+      {
+         if (fstat(fd, &st) == 0 && st.st_size > 0)
+         {
+            void *data = mmap(NULL, (size_t)st.st_size,
+                  PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED)
+            {
+               db->map         = (const uint8_t*)data;
+               db->map_size    = (uint64_t)st.st_size;
+               db->map_is_mmap = true;
+            }
+         }
+         /* The mapping stays valid after closing */
+         close(fd);
+         if (db->map)
+            return true;
+      }
+   }
+#endif
+
+   if (!filestream_read_file(db->path, &buf, &len) || len <= 0)
+   {
+      if (buf)
+         free(buf);
+      return false;
+   }
+
+   db->map      = (const uint8_t*)buf;
+   db->map_size = (uint64_t)len;
+   return true;
+}
+
+static uint64_t libretrodb_mem_read_be(const uint8_t *p, unsigned size)
+{
+   unsigned i;
+   uint64_t val = 0;
+   for (i = 0; i < size; i++)
+      val = (val << 8) | p[i];
+   return val;
+}
+
+int libretrodb_mem_read(const uint8_t **ptr, const uint8_t *end,
+      struct rmsgpack_dom_value *out)
+{
+   uint8_t type;
+   unsigned size      = 0;
+   const uint8_t *p   = *ptr;
+
+   if (p >= end)
+      return -1;
+
+   memset(out, 0, sizeof(*out));
+   type = *p++;
+
+   if (type < 0x80)
+   {
+      out->type       = RDT_INT;
+      out->val.int_   = type;
+   }
+   else if (type < 0x90)
+   {
+      out->type          = RDT_MAP;
+      out->val.map.len   = type & 0x0f;
+      out->val.map.items = NULL;
+   }
+   else if (type < 0xa0)
+   {
+      out->type            = RDT_ARRAY;
+      out->val.array.len   = type & 0x0f;
+      out->val.array.items = NULL;
+   }
+   else if (type < 0xc0)
+   {
+      out->type              = RDT_STRING;
+      out->val.string.len    = type & 0x1f;
+   }
+   else if (type >= 0xe0)
+   {
+      out->type       = RDT_INT;
+      out->val.int_   = (int8_t)type;
+   }
+   else
+   {
+      switch (type)
+      {
+         case 0xc0:
+            out->type          = RDT_NULL;
+            break;
+         case 0xc2:
+         case 0xc3:
+            out->type          = RDT_BOOL;
+            out->val.bool_     = type & 1;
+            break;
+         case 0xc4:
+         case 0xc5:
+         case 0xc6:
+            size               = 1 << (type - 0xc4);
+            if (p + size > end)
+               return -1;
+            out->type          = RDT_BINARY;
+            out->val.binary.len = (uint32_t)libretrodb_mem_read_be(p, size);
+            p                 += size;
+            break;
+         case 0xcc:
+         case 0xcd:
+         case 0xce:
+         case 0xcf:
+            size               = 1 << (type - 0xcc);
+            if (p + size > end)
+               return -1;
+            out->type          = RDT_UINT;
+            out->val.uint_     = libretrodb_mem_read_be(p, size);
+            p                 += size;
+            break;
+         case 0xd0:
+         case 0xd1:
+         case 0xd2:
+         case 0xd3:
+            size               = 1 << (type - 0xd0);
+            if (p + size > end)
+               return -1;
+            out->type          = RDT_INT;
+            out->val.int_      = (int64_t)libretrodb_mem_read_be(p, size);
+            /* Sign extend */
+            if (size < 8)
+               out->val.int_   = (out->val.int_ ^ ((int64_t)1 << (size * 8 - 1)))
+                                - ((int64_t)1 << (size * 8 - 1));
+            p                 += size;
+            break;
+         case 0xd9:
+         case 0xda:
+         case 0xdb:
+            size               = 1 << (type - 0xd9);
+            if (p + size > end)
+               return -1;
+            out->type          = RDT_STRING;
+            out->val.string.len = (uint32_t)libretrodb_mem_read_be(p, size);
+            p                 += size;
+            break;
+         case 0xdc:
+         case 0xdd:
+            size               = (type == 0xdc) ? 2 : 4;
+            if (p + size > end)
+               return -1;
+            out->type            = RDT_ARRAY;
+            out->val.array.len   = (uint32_t)libretrodb_mem_read_be(p, size);
+            out->val.array.items = NULL;
+            p                   += size;
+            break;
+         case 0xde:
+         case 0xdf:
+            size               = (type == 0xde) ? 2 : 4;
+            if (p + size > end)
+               return -1;
+            out->type          = RDT_MAP;
+            out->val.map.len   = (uint32_t)libretrodb_mem_read_be(p, size);
+            out->val.map.items = NULL;
+            p                 += size;
+            break;
+         default:
+            return -1;
+      }
+   }
+
+   if (out->type == RDT_STRING || out->type == RDT_BINARY)
+   {
+      /* string and binary share the same layout */
+      if ((uint64_t)(end - p) < out->val.string.len)
+         return -1;
+      out->val.string.buff = (char*)p;
+      p                   += out->val.string.len;
+   }
+
+   *ptr = p;
+   return 0;
+}
+
+int libretrodb_mem_skip(const uint8_t **ptr, const uint8_t *end)
+{
+   uint32_t i;
+   struct rmsgpack_dom_value val;
+
+   if (libretrodb_mem_read(ptr, end, &val) < 0)
+      return -1;
+
+   if (val.type == RDT_MAP)
+   {
+      for (i = 0; i < val.val.map.len * 2; i++)
+         if (libretrodb_mem_skip(ptr, end) < 0)
+            return -1;
+   }
+   else if (val.type == RDT_ARRAY)
+   {
+      for (i = 0; i < val.val.array.len; i++)
+         if (libretrodb_mem_skip(ptr, end) < 0)
+            return -1;
+   }
+
+   return 0;
+}
+
+/* Parses the chain of index headers following the metadata */
+static int libretrodb_load_indexes(libretrodb_t *db)
+{
+   const uint8_t *p;
+   const uint8_t *end;
+
+   if (db->indexes)
+      return 0;
+   if (!libretrodb_map(db))
+      return -1;
+
+   end = db->map + db->map_size;
+   p   = db->map + db->first_index_offset;
+
+   while (p < end)
+   {
+      uint32_t i;
+      struct rmsgpack_dom_value hdr;
+      libretrodb_index_t idx         = {{0}};
+      libretrodb_index_t *indexes    = NULL;
+
+      if (     libretrodb_mem_read(&p, end, &hdr) < 0
+            || hdr.type != RDT_MAP)
+         return -1;
+
+      for (i = 0; i < hdr.val.map.len; i++)
+      {
+         struct rmsgpack_dom_value key, val;
+
+         if (     libretrodb_mem_read(&p, end, &key) < 0
+               || libretrodb_mem_read(&p, end, &val) < 0
+               || key.type != RDT_STRING)
+            return -1;
+
+         if (val.type == RDT_STRING)
+         {
+            if (     key.val.string.len == STRLEN_CONST("name")
+                  && !memcmp(key.val.string.buff, "name", key.val.string.len))
+            {
+               size_t _len = MIN(val.val.string.len, sizeof(idx.name) - 1);
+               memcpy(idx.name, val.val.string.buff, _len);
+               idx.name[_len] = '\0';
+            }
+         }
+         else if (val.type == RDT_UINT || val.type == RDT_INT)
+         {
+            if (     key.val.string.len == STRLEN_CONST("key_size")
+                  && !memcmp(key.val.string.buff, "key_size", key.val.string.len))
+               idx.key_size = val.val.uint_;
+            else if (key.val.string.len == STRLEN_CONST("next")
+                  && !memcmp(key.val.string.buff, "next", key.val.string.len))
+               idx.next     = val.val.uint_;
+            else if (key.val.string.len == STRLEN_CONST("count")
+                  && !memcmp(key.val.string.buff, "count", key.val.string.len))
+               idx.count    = val.val.uint_;
+         }
+      }
+
+      idx.offset = (uint64_t)(p - db->map);
+
+      if (     idx.next > (uint64_t)(end - p)
+            || idx.count * (idx.key_size + sizeof(uint64_t)) > idx.next)
+         return -1;
+
+      if (!(indexes = (libretrodb_index_t*)realloc(db->indexes,
+                  (db->num_indexes + 1) * sizeof(*indexes))))
+         return -1;
+
+      db->indexes                    = indexes;
+      db->indexes[db->num_indexes++] = idx;
+      p                             += idx.next;
+   }
+
+   return 0;
+}
+
+static const libretrodb_index_t *libretrodb_get_index(libretrodb_t *db,
+      const char *index_name)
+{
+   unsigned i;
+
+   if (libretrodb_load_indexes(db) < 0)
+      return NULL;
+
+   for (i = 0; i < db->num_indexes; i++)
+      if (strncmp(index_name, db->indexes[i].name,
+               strlen(db->indexes[i].name)) == 0)
+         return &db->indexes[i];
+
+   return NULL;
+}
+
+/* Binary search over the mapped index, no copies made */
+static int libretrodb_index_search(libretrodb_t *db,
+      const libretrodb_index_t *idx, const void *key, uint64_t *offset)
+{
+   size_t item_size   = (size_t)idx->key_size + sizeof(uint64_t);
+   const uint8_t *buf = db->map + idx->offset;
+   uint64_t lo        = 0;
+   uint64_t hi        = idx->count;
+
+   while (lo < hi)
+   {
+      uint64_t mid         = lo + (hi - lo) / 2;
+      const uint8_t *item  = buf + mid * item_size;
+      int rv               = memcmp(item, key, (size_t)idx->key_size);
+
+      if (rv == 0)
+      {
+         memcpy(offset, item + idx->key_size, sizeof(*offset));
+         return 0;
+      }
+
+      if (rv > 0)
+         hi = mid;
+      else
+         lo = mid + 1;
+   }
+
+   return -1;
+}
+
 void libretrodb_close(libretrodb_t *db)
 {
+   libretrodb_unmap(db);
    if (db->fd)
       filestream_close(db->fd);
    if (!string_is_empty(db->path))
@@ -192,6 +579,8 @@ int libretrodb_open(const char *path, libretrodb_t *db, bool write)
    if (!fd)
      return -1;
 
+   libretrodb_unmap(db);
+
    if (!string_is_empty(db->path))
       free(db->path);
 
@@ -253,69 +642,73 @@ static int libretrodb_find_index(libretrodb_t *db, const char *index_name,
    return -1;
 }
 
-static int binsearch(const void *buff, const void *item,
-      uint64_t count, uint8_t field_size, uint64_t *offset)
+int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
+      const void *key, struct rmsgpack_dom_value *out)
 {
-   int mid            = (int)(count / 2);
-   int item_size      = field_size + sizeof(uint64_t);
-   uint8_t *current   = ((uint8_t *)buff + (mid * item_size));
-   int rv             = memcmp(current, item, field_size);
-
-   if (rv == 0)
-   {
-      *offset         = *(uint64_t *)(current + field_size);
-      return 0;
-   }
+   uint64_t offset;
+   const libretrodb_index_t *idx = libretrodb_get_index(db, index_name);
 
-   if (count == 0)
+   if (!idx || libretrodb_index_search(db, idx, key, &offset) < 0)
       return -1;
 
-   if (rv > 0)
-      return binsearch(buff, item, mid, field_size, offset);
-
-   return binsearch(current + item_size, item,
-         count - mid, field_size, offset);
+   filestream_seek(db->fd, (ssize_t)offset, RETRO_VFS_SEEK_POSITION_START);
+   if (rmsgpack_dom_read(db->fd, out) < 0)
+      return -1;
+   return 0;
 }
 
-int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
-      const void *key, struct rmsgpack_dom_value *out)
+int libretrodb_find_record(libretrodb_t *db, const char *index_name,
+      const void *key, libretrodb_record_t *out)
 {
-   libretrodb_index_t idx;
-   int rv;
-   uint8_t *buff;
    uint64_t offset;
-   ssize_t bufflen, nread = 0;
+   const libretrodb_index_t *idx = libretrodb_get_index(db, index_name);
 
-   if (libretrodb_find_index(db, index_name, &idx) < 0)
+   if (!idx || libretrodb_index_search(db, idx, key, &offset) < 0)
+      return -1;
+   if (offset >= db->map_size)
       return -1;
 
-   bufflen        = idx.next;
-   if (!(buff = (uint8_t*)malloc(bufflen)))
+   out->data = db->map + offset;
+   out->end  = db->map + db->map_size;
+   return 0;
+}
+
+int libretrodb_record_get_field(const libretrodb_record_t *rec,
+      const char *field, struct rmsgpack_dom_value *out)
+{
+   uint32_t i;
+   struct rmsgpack_dom_value map;
+   const uint8_t *p  = rec->data;
+   size_t field_len  = strlen(field);
+
+   if (     libretrodb_mem_read(&p, rec->end, &map) < 0
+         || map.type != RDT_MAP)
       return -1;
 
-   while (nread < bufflen)
+   for (i = 0; i < map.val.map.len; i++)
    {
-      void *buff_ = (buff + nread);
-      rv          = (int)filestream_read(db->fd, buff_, bufflen - nread);
+      struct rmsgpack_dom_value key;
 
-      if (rv <= 0)
-      {
-         free(buff);
+      if (libretrodb_mem_read(&p, rec->end, &key) < 0)
          return -1;
-      }
-      nread += rv;
-   }
 
-   rv = binsearch(buff, key, idx.count, (ssize_t)idx.key_size, &offset);
-   free(buff);
+      if (     key.type == RDT_STRING
+            && key.val.string.len == field_len
+            && !memcmp(key.val.string.buff, field, field_len))
+      {
+         if (libretrodb_mem_read(&p, rec->end, out) < 0)
+            return -1;
+         /* Nested values would need allocating */
+         if (out->type == RDT_MAP || out->type == RDT_ARRAY)
+            return -1;
+         return 0;
+      }
 
-   if (rv == 0) {
-      filestream_seek(db->fd, (ssize_t)offset, RETRO_VFS_SEEK_POSITION_START);
-      rmsgpack_dom_read(db->fd, out);
-      return 0;
-   } else {
-     return -1;
+      if (libretrodb_mem_skip(&p, rec->end) < 0)
+         return -1;
    }
+
+   return -1;
 }
 
 /**
@@ -329,11 +722,58 @@ int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
 int libretrodb_cursor_reset(libretrodb_cursor_t *cursor)
 {
    cursor->eof = 0;
+   cursor->pos = cursor->start;
    return (int)filestream_seek(cursor->fd,
          (ssize_t)(cursor->db->root + sizeof(libretrodb_header_t)),
          RETRO_VFS_SEEK_POSITION_START);
 }
 
+static int libretrodb_cursor_read_raw(libretrodb_cursor_t *cursor,
+      struct rmsgpack_dom_value *out)
+{
+   libretrodb_t *db   = cursor->db;
+   const uint8_t *end = db->map + db->map_size;
+
+   while (cursor->pos < db->map_size)
+   {
+      int rv;
+      const uint8_t *data = db->map + cursor->pos;
+      const uint8_t *next = data;
+
+      /* The record list ends with a nil */
+      if (*data == 0xc0)
+         break;
+
+      if (libretrodb_mem_skip(&next, end) < 0)
+         return -1;
+
+      if (cursor->flags & LIBRETRODB_CURSOR_FLAG_INDEXED)
+         cursor->pos = db->map_size;
+      else
+         cursor->pos = (uint64_t)(next - db->map);
+
+      if ((rv = libretrodb_query_filter_raw(cursor->query, data, next)) == 0)
+         continue;
+
+      /* Only matches get a DOM */
+      filestream_seek(cursor->fd, (ssize_t)(data - db->map),
+            RETRO_VFS_SEEK_POSITION_START);
+      if (rmsgpack_dom_read(cursor->fd, out) < 0)
+         return -1;
+
+      if (rv < 0 && !libretrodb_query_filter(cursor->query, out))
+      {
+         rmsgpack_dom_value_free(out);
+         continue;
+      }
+
+      return 0;
+   }
+
+   cursor->eof = 1;
+   return EOF;
+}
+
 int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
       struct rmsgpack_dom_value *out)
 {
@@ -342,6 +782,9 @@ int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
    if (cursor->eof)
       return EOF;
 
+   if (cursor->flags & LIBRETRODB_CURSOR_FLAG_RAW)
+      return libretrodb_cursor_read_raw(cursor, out);
+
 retry:
    if ((rv = rmsgpack_dom_read(cursor->fd, out)) < 0)
       return rv;
@@ -386,6 +829,70 @@ void libretrodb_cursor_close(libretrodb_cursor_t *cursor)
    cursor->fd       = NULL;
    cursor->db       = NULL;
    cursor->query    = NULL;
+   cursor->flags    = 0;
+}
+
+/* Sets up filtering on the mapped file when the query
+ * allows it, and narrows the scan down to one record when
+ * the query requires a key some index was built on */
+static void libretrodb_cursor_plan(libretrodb_cursor_t *cursor)
+{
+   unsigned i;
+   libretrodb_t *db = cursor->db;
+
+   cursor->flags    = 0;
+   cursor->start    = db->root + sizeof(libretrodb_header_t);
+
+   if (     !cursor->query
+         || !libretrodb_query_is_flat(cursor->query)
+         || !libretrodb_map(db))
+      return;
+
+   cursor->flags   |= LIBRETRODB_CURSOR_FLAG_RAW;
+
+   /* Index names are taken to be the name of the field
+    * they were built on, as libretrodb_tool creates them */
+   if (libretrodb_load_indexes(db) < 0)
+      return;
+
+   for (i = 0; i < db->num_indexes; i++)
+   {
+      uint64_t offset;
+      libretrodb_record_t rec;
+      struct rmsgpack_dom_value field;
+      const libretrodb_index_t *idx         = &db->indexes[i];
+      const struct rmsgpack_dom_value *key  =
+         libretrodb_query_get_equal_value(cursor->query, idx->name);
+
+      if (     !key
+            || key->type != RDT_BINARY
+            || key->val.binary.len != idx->key_size)
+         continue;
+
+      /* Keys are unique, a miss means an empty result */
+      if (libretrodb_index_search(db, idx, key->val.binary.buff, &offset) < 0)
+      {
+         cursor->flags |= LIBRETRODB_CURSOR_FLAG_INDEXED;
+         cursor->start  = db->map_size;
+         return;
+      }
+
+      /* Indexes written by older versions have a bad
+       * offset for the first record, scan those instead */
+      rec.data = db->map + offset;
+      rec.end  = db->map + db->map_size;
+      if (     offset < db->map_size
+            && libretrodb_record_get_field(&rec, idx->name, &field) == 0
+            && field.type == RDT_BINARY
+            && field.val.binary.len == idx->key_size
+            && !memcmp(field.val.binary.buff, key->val.binary.buff,
+               (size_t)idx->key_size))
+      {
+         cursor->flags |= LIBRETRODB_CURSOR_FLAG_INDEXED;
+         cursor->start  = offset;
+      }
+      return;
+   }
 }
 
 /**
@@ -414,12 +921,14 @@ int libretrodb_cursor_open(libretrodb_t *db,
    cursor->fd       = fd;
    cursor->db       = db;
    cursor->is_valid = 1;
-   libretrodb_cursor_reset(cursor);
    cursor->query    = q;
 
    if (q)
       libretrodb_query_inc_ref(q);
 
+   libretrodb_cursor_plan(cursor);
+   libretrodb_cursor_reset(cursor);
+
    return 0;
 }
 
@@ -451,7 +960,7 @@ int libretrodb_create_index(libretrodb_t *db,
    void *buff                       = NULL;
    uint64_t *buff_u64               = NULL;
    uint8_t field_size               = 0;
-   uint64_t item_loc                = filestream_tell(db->fd);
+   uint64_t item_loc                = 0;
    bintree_t *tree;
    uint64_t item_count              = 0;
    int rval                         = -1;
@@ -468,6 +977,8 @@ int libretrodb_create_index(libretrodb_t *db,
    if (!tree || (libretrodb_cursor_open(db, &cur, NULL) != 0))
       goto clean;
 
+   item_loc                         = filestream_tell(cur.fd);
+
    key.type                         = RDT_STRING;
    key.val.string.len               = (uint32_t)strlen(field_name);
    key.val.string.buff              = (char *)field_name;   /* We know we aren't going to change it */
@@ -541,6 +1052,8 @@ int libretrodb_create_index(libretrodb_t *db,
    bintree_iterate(tree->root, node_iter, &nictx);
 
    filestream_flush(db->fd);
+   /* The file grew, drop the cached indexes */
+   libretrodb_unmap(db);
 clean:
    rmsgpack_dom_value_free(&item);
    if (buff)
@@ -566,6 +1079,9 @@ libretrodb_cursor_t *libretrodb_cursor_new(void)
    dbc->eof                 = 0;
    dbc->query               = NULL;
    dbc->db                  = NULL;
+   dbc->start               = 0;
+   dbc->pos                 = 0;
+   dbc->flags               = 0;
 
    return dbc;
 }
@@ -584,6 +1100,11 @@ libretrodb_t *libretrodb_new(void)
       return NULL;
 
    db->fd                 = NULL;
+   db->map                = NULL;
+   db->map_size           = 0;
+   db->indexes            = NULL;
+   db->num_indexes        = 0;
+   db->map_is_mmap        = false;
    db->root               = 0;
    db->count              = 0;
    db->first_index_offset = 0;
@@ -45,6 +45,13 @@ typedef struct libretrodb_index libretrodb_index_t;
 
 typedef int (*libretrodb_value_provider)(void *ctx, struct rmsgpack_dom_value *out);
 
+/* View of an encoded record, valid until the database is closed */
+typedef struct libretrodb_record
+{
+   const uint8_t *data;
+   const uint8_t *end;
+} libretrodb_record_t;
+
 int libretrodb_create(RFILE *fd, libretrodb_value_provider value_provider, void *ctx);
 
 void libretrodb_close(libretrodb_t *db);
@@ -57,6 +64,66 @@ int libretrodb_create_index(libretrodb_t *db, const char *name,
 int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
         const void *key, struct rmsgpack_dom_value *out);
 
+/**
+ * libretrodb_find_record:
+ * @db                  : Handle to database.
+ * @index_name          : Name of the index to search.
+ * @key                 : Key to look up, of the index's key size.
+ * @out                 : View of the matching record.
+ *
+ * Like libretrodb_find_entry(), but decodes nothing.
+ * Use libretrodb_record_get_field() on the result.
+ *
+ * Returns: 0 if found, otherwise negative.
+ **/
+int libretrodb_find_record(libretrodb_t *db, const char *index_name,
+        const void *key, libretrodb_record_t *out);
+
+/**
+ * libretrodb_record_get_field:
+ * @rec                 : Record view.
+ * @field               : Name of the field.
+ * @out                 : Decoded value.
+ *
+ * Decodes a single scalar, string or binary field without
+ * allocating. Strings and binaries point into the database
+ * and are not NUL terminated, so @out must not be passed to
+ * rmsgpack_dom_value_free().
+ *
+ * Returns: 0 if found, otherwise negative.
+ **/
+int libretrodb_record_get_field(const libretrodb_record_t *rec,
+        const char *field, struct rmsgpack_dom_value *out);
+
+/**
+ * libretrodb_mem_read:
+ * @ptr                 : Position in an encoded buffer, advanced
+ *                        past the value on success.
+ * @end                 : End of the buffer.
+ * @out                 : Decoded value.
+ *
+ * Decodes the MessagePack value header at @ptr without
+ * allocating. Strings and binaries point into the buffer
+ * and are not NUL terminated, maps and arrays only get
+ * their length and @ptr is left at their first element.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int libretrodb_mem_read(const uint8_t **ptr, const uint8_t *end,
+        struct rmsgpack_dom_value *out);
+
+/**
+ * libretrodb_mem_skip:
+ * @ptr                 : Position in an encoded buffer.
+ * @end                 : End of the buffer.
+ *
+ * Advances @ptr past one complete value, including
+ * all elements of maps and arrays.
+ *
+ * Returns: 0 if successful, otherwise negative.
+ **/
+int libretrodb_mem_skip(const uint8_t **ptr, const uint8_t *end);
+
 libretrodb_t *libretrodb_new(void);
 
 void libretrodb_free(libretrodb_t *db);
@@ -0,0 +1,248 @@
+/* Copyright  (C) 2010-2023 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (libretrodb_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Builds a synthetic database, then times random
+ * CRC lookups through the index and a few queries. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <streams/file_stream.h>
+
+#include "libretrodb.h"
+#include "rmsgpack_dom.h"
+
+#define BENCH_DEFAULT_RECORDS 200000
+#define BENCH_LOOKUPS         100000
+#define BENCH_QUERY_RUNS      20
+
+static const char *bench_queries[] = {
+   "{'name':glob('*12345 *')}",
+   "{'serial':'SYN-00000042'}",
+   "{'crc':b'9E3779B1'}",
+   NULL
+};
+
+struct bench_ctx
+{
+   uint32_t i;
+   uint32_t count;
+   char name[64];
+   char serial[16];
+   uint8_t crc[4];
+};
+
+/* Odd multiplier, so every record gets a unique CRC */
+static void bench_crc(uint32_t i, uint8_t *crc)
+{
+   uint32_t v = i * 2654435761U;
+   crc[0]     = (uint8_t)(v >> 24);
+   crc[1]     = (uint8_t)(v >> 16);
+   crc[2]     = (uint8_t)(v >>  8);
+   crc[3]     = (uint8_t)(v);
+}
+
+static int bench_value_provider(void *data, struct rmsgpack_dom_value *out)
+{
+   struct bench_ctx *ctx = (struct bench_ctx*)data;
+   struct rmsgpack_dom_pair *items;
+
+   if (ctx->i >= ctx->count)
+      return 1;
+
+   if (!(items = (struct rmsgpack_dom_pair*)calloc(3, sizeof(*items))))
+      return -1;
+
+   snprintf(ctx->name, sizeof(ctx->name), "Synthetic Game %u (World)", ctx->i);
+   snprintf(ctx->serial, sizeof(ctx->serial), "SYN-%08u", ctx->i);
+   bench_crc(ctx->i, ctx->crc);
+
+   items[0].key.type                = RDT_STRING;
+   items[0].key.val.string.buff     = strdup("name");
+   items[0].key.val.string.len      = 4;
+   items[0].value.type              = RDT_STRING;
+   items[0].value.val.string.buff   = strdup(ctx->name);
+   items[0].value.val.string.len    = (uint32_t)strlen(ctx->name);
+
+   items[1].key.type                = RDT_STRING;
+   items[1].key.val.string.buff     = strdup("serial");
+   items[1].key.val.string.len      = 6;
+   items[1].value.type              = RDT_STRING;
+   items[1].value.val.string.buff   = strdup(ctx->serial);
+   items[1].value.val.string.len    = (uint32_t)strlen(ctx->serial);
+
+   items[2].key.type                = RDT_STRING;
+   items[2].key.val.string.buff     = strdup("crc");
+   items[2].key.val.string.len      = 3;
+   items[2].value.type              = RDT_BINARY;
+   items[2].value.val.binary.buff   = (char*)malloc(sizeof(ctx->crc));
+   items[2].value.val.binary.len    = sizeof(ctx->crc);
+   memcpy(items[2].value.val.binary.buff, ctx->crc, sizeof(ctx->crc));
+
+   out->type          = RDT_MAP;
+   out->val.map.len   = 3;
+   out->val.map.items = items;
+
+   ctx->i++;
+   return 0;
+}
+
+static double bench_elapsed_ms(clock_t start)
+{
+   return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void bench_query(libretrodb_t *db, const char *query_exp)
+{
+   unsigned i;
+   clock_t start;
+   const char *error    = NULL;
+   unsigned found       = 0;
+   libretrodb_query_t *q = (libretrodb_query_t*)
+      libretrodb_query_compile(db, query_exp, strlen(query_exp), &error);
+
+   if (!q)
+   {
+      printf("Could not compile '%s': %s\n", query_exp, error);
+      return;
+   }
+
+   start = clock();
+   for (i = 0; i < BENCH_QUERY_RUNS; i++)
+   {
+      struct rmsgpack_dom_value item;
+      libretrodb_cursor_t *cur = libretrodb_cursor_new();
+
+      if (!cur || libretrodb_cursor_open(db, cur, q) != 0)
+      {
+         libretrodb_cursor_free(cur);
+         break;
+      }
+      while (libretrodb_cursor_read_item(cur, &item) == 0)
+      {
+         found++;
+         rmsgpack_dom_value_free(&item);
+      }
+      libretrodb_cursor_close(cur);
+      libretrodb_cursor_free(cur);
+   }
+   printf("query:       %u runs, %u found, %.2f ms/run, %s\n",
+         BENCH_QUERY_RUNS, found,
+         bench_elapsed_ms(start) / BENCH_QUERY_RUNS, query_exp);
+
+   libretrodb_query_free(q);
+}
+
+int main(int argc, char **argv)
+{
+   uint32_t i;
+   clock_t start;
+   struct bench_ctx ctx;
+   RFILE *fd            = NULL;
+   libretrodb_t *db     = NULL;
+   unsigned found       = 0;
+   uint32_t count       = BENCH_DEFAULT_RECORDS;
+   int ret              = 1;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <db file> [number of records]\n", argv[0]);
+      return 1;
+   }
+
+   if (argc > 2)
+      count = (uint32_t)strtoul(argv[2], NULL, 10);
+   if (count == 0)
+      count = BENCH_DEFAULT_RECORDS;
+
+   memset(&ctx, 0, sizeof(ctx));
+   ctx.count = count;
+
+   if (!(fd = filestream_open(argv[1], RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+   {
+      printf("Could not open db file '%s'\n", argv[1]);
+      return 1;
+   }
+
+   start = clock();
+   libretrodb_create(fd, bench_value_provider, &ctx);
+   filestream_close(fd);
+   printf("Created %u records in %.1f ms\n", count, bench_elapsed_ms(start));
+
+   if (!(db = libretrodb_new()) || libretrodb_open(argv[1], db, true) != 0)
+   {
+      printf("Could not open db file '%s'\n", argv[1]);
+      goto end;
+   }
+
+   start = clock();
+   libretrodb_create_index(db, "crc", "crc");
+   printf("Created index in %.1f ms\n", bench_elapsed_ms(start));
+
+   srand(1);
+   start = clock();
+   for (i = 0; i < BENCH_LOOKUPS; i++)
+   {
+      uint8_t crc[4];
+      struct rmsgpack_dom_value item;
+
+      bench_crc((uint32_t)rand() % count, crc);
+      if (libretrodb_find_entry(db, "crc", crc, &item) == 0)
+      {
+         found++;
+         rmsgpack_dom_value_free(&item);
+      }
+   }
+   printf("find_entry:  %u lookups, %u found, %.1f ms\n",
+         BENCH_LOOKUPS, found, bench_elapsed_ms(start));
+
+   srand(1);
+   found = 0;
+   start = clock();
+   for (i = 0; i < BENCH_LOOKUPS; i++)
+   {
+      uint8_t crc[4];
+      libretrodb_record_t rec;
+      struct rmsgpack_dom_value name;
+
+      bench_crc((uint32_t)rand() % count, crc);
+      if (     libretrodb_find_record(db, "crc", crc, &rec) == 0
+            && libretrodb_record_get_field(&rec, "name", &name) == 0)
+         found++;
+   }
+   printf("find_record: %u lookups, %u found, %.1f ms\n",
+         BENCH_LOOKUPS, found, bench_elapsed_ms(start));
+
+   ret = (found == BENCH_LOOKUPS) ? 0 : 1;
+
+   for (i = 0; bench_queries[i]; i++)
+      bench_query(db, bench_queries[i]);
+
+   libretrodb_close(db);
+end:
+   if (db)
+      libretrodb_free(db);
+   return ret;
+}
@@ -80,9 +80,21 @@ struct argument
    enum argument_type type;
 };
 
+/* One field test of a top level table, the flat form
+ * a table query is compiled to so it can be evaluated
+ * on encoded records */
+struct query_term
+{
+   const struct argument *arg;   /* value or function to apply */
+   const char *field;            /* not NUL terminated */
+   uint32_t field_len;
+};
+
 struct query
 {
    struct invocation root; /* ptr alignment */
+   struct query_term *terms;     /* NULL if not a plain table */
+   unsigned num_terms;
    unsigned ref_count;
 };
 
@@ -911,11 +923,48 @@ void libretrodb_query_free(void *q)
       query_argument_free(&real_q->root.argv[i]);
 
    free(real_q->root.argv);
+   free(real_q->terms);
    real_q->root.argv = NULL;
    real_q->root.argc = 0;
+   real_q->terms     = NULL;
+   real_q->num_terms = 0;
    free(real_q);
 }
 
+/* Flattens a top level table into one term per field.
+ * Anything else is left to the DOM evaluator. */
+static void query_compile_terms(struct query *q)
+{
+   unsigned i;
+   struct query_term *terms = NULL;
+
+   if (     q->root.func != query_func_all_map
+         || q->root.argc == 0
+         || q->root.argc % 2 != 0)
+      return;
+
+   for (i = 0; i < q->root.argc; i += 2)
+      if (     q->root.argv[i].type         != AT_VALUE
+            || q->root.argv[i].a.value.type != RDT_STRING)
+         return;
+
+   if (!(terms = (struct query_term*)
+            malloc((q->root.argc / 2) * sizeof(*terms))))
+      return;
+
+   for (i = 0; i < q->root.argc; i += 2)
+   {
+      const struct rmsgpack_dom_value *key = &q->root.argv[i].a.value;
+      struct query_term *term              = &terms[i / 2];
+      term->field                          = key->val.string.buff;
+      term->field_len                      = key->val.string.len;
+      term->arg                            = &q->root.argv[i + 1];
+   }
+
+   q->terms     = terms;
+   q->num_terms = q->root.argc / 2;
+}
+
 void *libretrodb_query_compile(libretrodb_t *db,
       const char *query, size_t buff_len, const char **error_string)
 {
@@ -932,6 +981,8 @@ void *libretrodb_query_compile(libretrodb_t *db,
    q->root.argc          = 0;
    q->root.func          = NULL;
    q->root.argv          = NULL;
+   q->terms              = NULL;
+   q->num_terms          = 0;
 
    buff.data             = query;
    buff.len              = buff_len;
@@ -969,6 +1020,8 @@ void *libretrodb_query_compile(libretrodb_t *db,
       goto error;
    }
 
+   query_compile_terms(q);
+
    return q;
 
 error:
@@ -991,3 +1044,134 @@ int libretrodb_query_filter(libretrodb_query_t *q,
    struct rmsgpack_dom_value res = inv.func(*v, inv.argc, inv.argv);
    return (res.type == RDT_BOOL && res.val.bool_);
 }
+
+bool libretrodb_query_is_flat(libretrodb_query_t *q)
+{
+   return ((struct query*)q)->terms != NULL;
+}
+
+static bool query_term_eval(const struct query_term *term,
+      struct rmsgpack_dom_value value)
+{
+   struct rmsgpack_dom_value res;
+   char buf[256];
+   char *tmp = NULL;
+
+   /* Equality compares strings by length */
+   if (term->arg->type == AT_VALUE)
+      return func_equals(value, 1, term->arg).val.bool_;
+
+   /* Functions expect NUL terminated strings */
+   if (value.type == RDT_STRING)
+   {
+      if (value.val.string.len < sizeof(buf))
+         tmp = buf;
+      else if (!(tmp = (char*)malloc(value.val.string.len + 1)))
+         return false;
+      memcpy(tmp, value.val.string.buff, value.val.string.len);
+      tmp[value.val.string.len] = '\0';
+      value.val.string.buff     = tmp;
+   }
+
+   res = query_func_is_true(term->arg->a.invocation.func(value,
+            term->arg->a.invocation.argc,
+            term->arg->a.invocation.argv), 0, NULL);
+
+   if (tmp && tmp != buf)
+      free(tmp);
+   return res.val.bool_;
+}
+
+int libretrodb_query_filter_raw(libretrodb_query_t *q,
+      const uint8_t *data, const uint8_t *end)
+{
+   uint32_t i;
+   unsigned j;
+   struct rmsgpack_dom_value map;
+   struct rmsgpack_dom_value nil_value;
+   bool seen[QUERY_MAX_ARGS / 2];
+   struct query *rq = (struct query*)q;
+   const uint8_t *p = data;
+
+   if (!rq->terms)
+      return -1;
+
+   if (     libretrodb_mem_read(&p, end, &map) < 0
+         || map.type != RDT_MAP)
+      return -1;
+
+   memset(seen, 0, sizeof(seen));
+
+   for (i = 0; i < map.val.map.len; i++)
+   {
+      struct rmsgpack_dom_value key;
+      struct rmsgpack_dom_value value;
+      bool wanted = false;
+
+      if (libretrodb_mem_read(&p, end, &key) < 0)
+         return -1;
+
+      if (key.type == RDT_STRING)
+      {
+         for (j = 0; j < rq->num_terms; j++)
+         {
+            if (     rq->terms[j].field_len == key.val.string.len
+                  && !memcmp(rq->terms[j].field, key.val.string.buff,
+                     key.val.string.len))
+            {
+               wanted = true;
+               break;
+            }
+         }
+      }
+
+      /* Fields the query doesn't look at are never decoded */
+      if (!wanted)
+      {
+         if (libretrodb_mem_skip(&p, end) < 0)
+            return -1;
+         continue;
+      }
+
+      if (libretrodb_mem_read(&p, end, &value) < 0)
+         return -1;
+      /* Nested values would need a DOM */
+      if (value.type == RDT_MAP || value.type == RDT_ARRAY)
+         return -1;
+
+      for (; j < rq->num_terms; j++)
+      {
+         if (     rq->terms[j].field_len != key.val.string.len
+               || memcmp(rq->terms[j].field, key.val.string.buff,
+                  key.val.string.len))
+            continue;
+         seen[j] = true;
+         if (!query_term_eval(&rq->terms[j], value))
+            return 0;
+      }
+   }
+
+   /* All missing fields are nil */
+   nil_value.type = RDT_NULL;
+   for (j = 0; j < rq->num_terms; j++)
+      if (!seen[j] && !query_term_eval(&rq->terms[j], nil_value))
+         return 0;
+
+   return 1;
+}
+
+const struct rmsgpack_dom_value *libretrodb_query_get_equal_value(
+      libretrodb_query_t *q, const char *field)
+{
+   unsigned i;
+   struct query *rq = (struct query*)q;
+   size_t field_len = strlen(field);
+
+   for (i = 0; i < rq->num_terms; i++)
+      if (     rq->terms[i].arg->type == AT_VALUE
+            && rq->terms[i].field_len == field_len
+            && !memcmp(rq->terms[i].field, field, field_len))
+         return &rq->terms[i].arg->a.value;
+
+   return NULL;
+}
@@ -23,6 +23,9 @@
 #ifndef __LIBRETRODB_QUERY_H__
 #define __LIBRETRODB_QUERY_H__
 
+#include <stdint.h>
+
+#include <boolean.h>
 #include <retro_common_api.h>
 
 #include "libretrodb.h"
@@ -38,6 +41,41 @@ void libretrodb_query_dec_ref(libretrodb_query_t *q);
 
 int libretrodb_query_filter(libretrodb_query_t *q, struct rmsgpack_dom_value *v);
 
+/**
+ * libretrodb_query_is_flat:
+ * @q                   : Compiled query.
+ *
+ * Returns: true if @q is a table of field tests, which
+ * libretrodb_query_filter_raw() can evaluate.
+ **/
+bool libretrodb_query_is_flat(libretrodb_query_t *q);
+
+/**
+ * libretrodb_query_filter_raw:
+ * @q                   : Compiled query.
+ * @data                : Start of an encoded record.
+ * @end                 : End of the record.
+ *
+ * Evaluates a table query directly on the encoded record,
+ * only decoding the fields the query refers to.
+ *
+ * Returns: 1 if the record matches, 0 if it doesn't, or
+ * -1 if the query or record needs libretrodb_query_filter().
+ **/
+int libretrodb_query_filter_raw(libretrodb_query_t *q,
+      const uint8_t *data, const uint8_t *end);
+
+/**
+ * libretrodb_query_get_equal_value:
+ * @q                   : Compiled query.
+ * @field               : Field name.
+ *
+ * Returns: the value @field must be equal to for a record
+ * to match, or NULL if the query doesn't require one.
+ **/
+const struct rmsgpack_dom_value *libretrodb_query_get_equal_value(
+      libretrodb_query_t *q, const char *field);
+
 RETRO_END_DECLS
 
 #endif
@@ -182,6 +182,8 @@
 #include "msg_hash.h"
 #include "paths.h"
 #include "file_path_special.h"
+#include "benchmark.h"
+#include "trace.h"
 #include "ui/ui_companion_driver.h"
 #include "verbosity.h"
 
@@ -290,7 +292,10 @@ enum
    RA_OPT_SET_SHADER,
    RA_OPT_DATABASE_SCAN,
    RA_OPT_ACCESSIBILITY,
-   RA_OPT_LOAD_MENU_ON_ERROR
+   RA_OPT_LOAD_MENU_ON_ERROR,
+   RA_OPT_BENCHMARK,
+   RA_OPT_BENCHMARK_KEEP_DRIVERS,
+   RA_OPT_TRACE
 };
 
 /* DRIVERS */
@@ -5775,6 +5780,8 @@ void main_exit(void *args)
       runloop_log_counters(p_rarch->perf_counters_rarch, p_rarch->perf_ptr_rarch);
    }
 
+   benchmark_report();
+
 #if defined(HAVE_LOGGER) && !defined(ANDROID)
    logger_shutdown();
 #endif
@@ -5804,6 +5811,7 @@ void main_exit(void *args)
    retroarch_ctl(RARCH_CTL_STATE_FREE,  NULL);
    global_free(p_rarch);
    task_queue_deinit();
+   trace_deinit();
 
    ui_companion_driver_deinit();
    retroarch_config_deinit();
@@ -6552,6 +6560,14 @@ static void retroarch_print_help(const char *arg0)
          "Detach program from the running console. Not relevant for all platforms.\n"
          "      --max-frames=NUMBER        "
          "Runs for the specified number of frames, then exits.\n"
+         "      --benchmark=NUMBER         "
+         "Runs the specified number of frames uncapped with null drivers,\n"
+         "                                 "
+         "then prints a JSON timing report and exits.\n"
+         "      --benchmark-keep-drivers   "
+         "Keeps the configured drivers in benchmark mode.\n"
+         "      --trace=FILE               "
+         "Records a Chrome trace of the frame loop, written to FILE on exit.\n"
          , sizeof(buf) - _len);
 
 #ifdef HAVE_PATCH
@@ -6790,6 +6806,9 @@ static bool retroarch_parse_input_and_config(
    bool                 cli_active = false;
    bool               cli_core_set = false;
    bool            cli_content_set = false;
+   bool          benchmark_enable  = false;
+   bool    benchmark_keep_drivers  = false;
+   unsigned       benchmark_frames = 0;
    recording_state_t *recording_st = recording_state_get_ptr();
    video_driver_state_t *video_st  = video_state_get_ptr();
    runloop_state_t     *runloop_st = runloop_state_get_ptr();
@@ -6854,6 +6873,9 @@ static bool retroarch_parse_input_and_config(
       { "max-frames",         1, NULL, RA_OPT_MAX_FRAMES },
       { "max-frames-ss",      0, NULL, RA_OPT_MAX_FRAMES_SCREENSHOT },
       { "max-frames-ss-path", 1, NULL, RA_OPT_MAX_FRAMES_SCREENSHOT_PATH },
+      { "benchmark",          1, NULL, RA_OPT_BENCHMARK },
+      { "benchmark-keep-drivers", 0, NULL, RA_OPT_BENCHMARK_KEEP_DRIVERS },
+      { "trace",              1, NULL, RA_OPT_TRACE },
       { "eof-exit",           0, NULL, RA_OPT_EOF_EXIT },
       { "version",            0, NULL, 'V' /* RA_OPT_VERSION */ },
       { "log-file",           1, NULL, RA_OPT_LOG_FILE },
@@ -7385,6 +7407,20 @@ static bool retroarch_parse_input_and_config(
 #endif
                break;
 
+            case RA_OPT_BENCHMARK:
+               benchmark_enable        = true;
+               benchmark_frames        = (unsigned)strtoul(optarg, NULL, 10);
+               break;
+
+            case RA_OPT_BENCHMARK_KEEP_DRIVERS:
+               benchmark_keep_drivers  = true;
+               break;
+
+            case RA_OPT_TRACE:
+               if (!trace_init(optarg))
+                  RARCH_ERR("[Trace]: Failed to start tracing.\n");
+               break;
+
             case RA_OPT_MAX_FRAMES_SCREENSHOT_PATH:
 #ifdef HAVE_SCREENSHOTS
                strlcpy(runloop_st->max_frames_screenshot_path,
@@ -7483,6 +7519,13 @@ static bool retroarch_parse_input_and_config(
       }
    }
 
+   if (benchmark_enable)
+   {
+      if (!benchmark_init(benchmark_frames, benchmark_keep_drivers))
+         retroarch_fail(1, "retroarch_parse_input()");
+      benchmark_apply_settings(settings);
+   }
+
 #ifdef HAVE_GIT_VERSION
    RARCH_LOG("RetroArch %s (Git %s)\n",
          PACKAGE_VERSION, retroarch_git_version);
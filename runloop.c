@@ -191,6 +191,9 @@
 #include "msg_hash.h"
 #include "paths.h"
 #include "file_path_special.h"
+#include "frame_pacer.h"
+#include "benchmark.h"
+#include "trace.h"
 #include "ui/ui_companion_driver.h"
 #include "verbosity.h"
 
@@ -4774,6 +4777,7 @@ bool runloop_event_init_core(
 
    runloop_set_frame_limit(&video_st->av_info, fastforward_ratio);
    runloop_st->frame_limit_last_time    = cpu_features_get_time_usec();
+   frame_pacer_reset_stats();
 
    runloop_runtime_log_init(runloop_st);
    return true;
@@ -6153,6 +6157,7 @@ static enum runloop_state_enum runloop_check_state(
          char s[128];
          bool rewinding      = false;
          static bool old_rewind_pressed = false;
+         static struct retro_perf_counter rewind_perf = {0};
 #ifdef EMULATORJS
          bool rewind_pressed = EJS_IS_REWIND();
 #else
@@ -6178,6 +6183,9 @@ static enum runloop_state_enum runloop_check_state(
             return RUNLOOP_STATE_PAUSE;
          }
 
+         performance_counter_init(rewind_perf, "rewind");
+         performance_counter_start_plus(runloop_st->perfcnt_enable,
+               rewind_perf);
          rewinding           = state_manager_check_rewind(
                &runloop_st->rewind_st,
                &runloop_st->current_core,
@@ -6190,6 +6198,8 @@ static enum runloop_state_enum runloop_check_state(
 #endif
                ,
                s, sizeof(s), &t);
+         performance_counter_stop_plus(runloop_st->perfcnt_enable,
+               rewind_perf);
 
          old_rewind_pressed = rewind_pressed;
 
@@ -6844,16 +6854,7 @@ static enum runloop_state_enum runloop_check_state(
 
 
 
-/**
- * runloop_iterate:
- *
- * Run Libretro core in RetroArch for one frame.
- *
- * Returns: 0 on success, 1 if we have to wait until
- * button input in order to wake up the loop,
- * -1 if we forcibly quit out of the RetroArch iteration loop.
- **/
-int runloop_iterate(void)
+static int runloop_iterate_frame(void)
 {
    int i;
    enum analog_dpad_mode dpad_mode[MAX_USERS];
@@ -7118,6 +7119,7 @@ int runloop_iterate(void)
    }
 
    {
+      static struct retro_perf_counter core_run_perf = {0};
 #ifdef HAVE_RUNAHEAD
       bool run_ahead_enabled            = settings->bools.run_ahead_enabled;
       unsigned run_ahead_num_frames     = settings->uints.run_ahead_frames;
@@ -7132,6 +7134,10 @@ int runloop_iterate(void)
             && !netplay_driver_ctl(RARCH_NETPLAY_CTL_IS_ENABLED, NULL);
 #endif
 
+      performance_counter_init(core_run_perf, "core_run");
+      performance_counter_start_plus(runloop_st->perfcnt_enable,
+            core_run_perf);
+
       if (want_runahead)
          runahead_run(
                runloop_st,
@@ -7141,10 +7147,20 @@ int runloop_iterate(void)
       else if (runloop_st->preempt_data)
          preempt_run(runloop_st->preempt_data, runloop_st);
       else
+#else
+      performance_counter_init(core_run_perf, "core_run");
+      performance_counter_start_plus(runloop_st->perfcnt_enable,
+            core_run_perf);
 #endif
          core_run();
+
+      performance_counter_stop_plus(runloop_st->perfcnt_enable,
+            core_run_perf);
    }
 
+   if (benchmark_state_get_ptr()->flags & BENCHMARK_FLAG_ACTIVE)
+      benchmark_frame();
+
    /* Increment runtime tick counter after each call to
     * core_run() or run_ahead() */
    runloop_st->core_runtime_usec += runloop_core_runtime_tick(
@@ -7256,26 +7272,20 @@ end:
               || (runloop_st->flags & RUNLOOP_FLAG_PAUSED)))
    {
       const retro_time_t end_frame_time  = cpu_features_get_time_usec();
-      const retro_time_t to_sleep_ms     = (
-            (  runloop_st->frame_limit_last_time
-             + runloop_st->frame_limit_minimum_time)
-            - end_frame_time) / 1000;
+      const retro_time_t deadline        =
+              runloop_st->frame_limit_last_time
+            + runloop_st->frame_limit_minimum_time;
 
-      if (to_sleep_ms > 0)
+      if (deadline > end_frame_time)
       {
-         unsigned               sleep_ms = (unsigned)to_sleep_ms;
+         /* Advance by exactly one frame period so
+          * wake-up lateness doesn't accumulate. */
+         runloop_st->frame_limit_last_time = deadline;
 
-         /* Combat jitter a bit. */
-         runloop_st->frame_limit_last_time +=
-            runloop_st->frame_limit_minimum_time;
-
-         if (sleep_ms > 0)
-         {
 #if defined(HAVE_COCOATOUCH)
-            if (!(uico_state_get_ptr()->flags & UICO_ST_FLAG_IS_ON_FOREGROUND))
+         if (!(uico_state_get_ptr()->flags & UICO_ST_FLAG_IS_ON_FOREGROUND))
 #endif
-               retro_sleep(sleep_ms);
-         }
+            frame_pacer_sleep_until(deadline, true);
 
          return 1;
       }
@@ -7299,6 +7309,24 @@ end:
    return 0;
 }
 
+/**
+ * runloop_iterate:
+ *
+ * Run Libretro core in RetroArch for one frame.
+ *
+ * Returns: 0 on success, 1 if we have to wait until
+ * button input in order to wake up the loop,
+ * -1 if we forcibly quit out of the RetroArch iteration loop.
+ **/
+int runloop_iterate(void)
+{
+   int ret;
+   TRACE_BEGIN("runloop_iterate");
+   ret = runloop_iterate_frame();
+   TRACE_END("runloop_iterate");
+   return ret;
+}
+
 void runloop_msg_queue_deinit(void)
 {
    runloop_state_t *runloop_st = &runloop_state;
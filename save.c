@@ -27,6 +27,7 @@
 #include <file/file_path.h>
 #include <string/stdstring.h>
 #include <time/rtime.h>
+#include <retro_miscellaneous.h>
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -53,14 +54,10 @@ struct ram_type
 static struct string_list *task_save_files = NULL;
 
 #ifdef HAVE_THREADS
-typedef struct autosave autosave_t;
+/* Granularity at which SRAM changes are detected */
+#define AUTOSAVE_BLOCK_SIZE 4096
 
-/* Autosave support. */
-struct autosave_st
-{
-   autosave_t **list;
-   unsigned num;
-};
+typedef struct autosave autosave_t;
 
 enum autosave_flags
 {
@@ -73,78 +70,159 @@ struct autosave
    void *buffer;
    const void *retro_buffer;
    const char *path;
-   slock_t *lock;
+   size_t bufsize;
+};
+
+/* Autosave support. A single thread serves all
+ * SRAM buffers. */
+struct autosave_st
+{
+   autosave_t **list;
+   slock_t *lock;                /* held while the core runs */
    slock_t *cond_lock;
    scond_t *cond;
    sthread_t *thread;
-   size_t bufsize;
+   unsigned num;
    unsigned interval;
    uint8_t flags;
 };
 
 static struct autosave_st autosave_state;
 
+/**
+ * autosave_snapshot:
+ * @save            : pointer to autosave object
+ *
+ * Brings the snapshot buffer up to date with
+ * the core's SRAM.
+ *
+ * Returns: true if anything changed.
+ **/
+static bool autosave_snapshot(autosave_t *save)
+{
+   size_t i;
+   bool differ         = false;
+   uint8_t *dst        = (uint8_t*)save->buffer;
+   const uint8_t *src  = (const uint8_t*)save->retro_buffer;
+
+   /* SRAM rarely changes, so look for differences
+    * without the lock first. Anything this misses
+    * because the core was writing at the time is
+    * picked up by the next pass. */
+   if (!memcmp(dst, src, save->bufsize))
+      return false;
+
+   /* Only the changed blocks are copied, which keeps
+    * the main thread waiting as little as possible */
+   slock_lock(autosave_state.lock);
+   for (i = 0; i < save->bufsize; i += AUTOSAVE_BLOCK_SIZE)
+   {
+      size_t _len = MIN(AUTOSAVE_BLOCK_SIZE, save->bufsize - i);
+      if (memcmp(dst + i, src + i, _len))
+      {
+         memcpy(dst + i, src + i, _len);
+         differ = true;
+      }
+   }
+   slock_unlock(autosave_state.lock);
+
+   return differ;
+}
+
+/**
+ * autosave_write:
+ * @save            : pointer to autosave object
+ * @compress        : write an RZIP compressed file
+ *
+ * Writes the snapshot to a temporary file, then moves it
+ * over the save file, so that a crash while writing never
+ * leaves a truncated save behind.
+ **/
+static bool autosave_write(autosave_t *save, bool compress)
+{
+   char tmp_path[PATH_MAX_LENGTH];
+   intfstream_t *file = NULL;
+   int64_t written    = -1;
+   size_t _len        = strlcpy(tmp_path, save->path, sizeof(tmp_path));
+
+   strlcpy(tmp_path + _len, ".tmp", sizeof(tmp_path) - _len);
+
+   if (compress)
+      file = intfstream_open_rzip_file(tmp_path,
+            RETRO_VFS_FILE_ACCESS_WRITE);
+   else
+      file = intfstream_open_file(tmp_path,
+            RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!file)
+      return false;
+
+   written = intfstream_write(file, save->buffer, save->bufsize);
+   intfstream_flush(file);
+   intfstream_close(file);
+   free(file);
+
+   if (written != (int64_t)save->bufsize)
+   {
+      filestream_delete(tmp_path);
+      return false;
+   }
+
+   if (filestream_rename(tmp_path, save->path) != 0)
+   {
+      /* Renaming over an existing file fails on Windows.
+       * Should this go wrong, the complete copy is still
+       * left in the temporary file. */
+      filestream_delete(save->path);
+      if (filestream_rename(tmp_path, save->path) != 0)
+         return false;
+   }
+
+   return true;
+}
 
 /**
  * autosave_thread:
- * @data            : pointer to autosave object
+ * @data            : pointer to autosave state
  *
  * Callback function for (threaded) autosave.
  **/
 static void autosave_thread(void *data)
 {
-   autosave_t *save = (autosave_t*)data;
+   struct autosave_st *state = (struct autosave_st*)data;
+   bool compress             = (state->flags & AUTOSAVE_FLAG_COMPRESS_FILES)
+      ? true : false;
 
    for (;;)
    {
-      bool differ;
+      unsigned i;
 
-      slock_lock(save->lock);
-      differ = memcmp(save->buffer, save->retro_buffer,
-            save->bufsize) != 0;
-      if (differ)
-         memcpy(save->buffer, save->retro_buffer, save->bufsize);
-      slock_unlock(save->lock);
-
-      if (differ)
+      for (i = 0; i < state->num; i++)
       {
-         intfstream_t *file = NULL;
-
-         /* Should probably deal with this more elegantly. */
-         if (save->flags & AUTOSAVE_FLAG_COMPRESS_FILES)
-            file = intfstream_open_rzip_file(save->path,
-                  RETRO_VFS_FILE_ACCESS_WRITE);
-         else
-            file = intfstream_open_file(save->path,
-                  RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
-
-         if (file)
-         {
-            intfstream_write(file, save->buffer, save->bufsize);
-            intfstream_flush(file);
-            intfstream_close(file);
-            free(file);
-         }
+         autosave_t *save = state->list[i];
+         if (save && autosave_snapshot(save))
+            if (!autosave_write(save, compress))
+               RARCH_WARN("[SRAM]: Failed to autosave \"%s\".\n", save->path);
       }
 
-      slock_lock(save->cond_lock);
+      slock_lock(state->cond_lock);
 
-      if (save->flags & AUTOSAVE_FLAG_QUIT)
+      if (state->flags & AUTOSAVE_FLAG_QUIT)
       {
-         slock_unlock(save->cond_lock);
+         slock_unlock(state->cond_lock);
          break;
       }
 
-      scond_wait_timeout(save->cond,
-            save->cond_lock,
+      scond_wait_timeout(state->cond,
+            state->cond_lock,
 #if defined(_MSC_VER) && _MSC_VER <= 1200
-            save->interval * 1000000
+            state->interval * 1000000
 #else
-            save->interval * 1000000LL
+            state->interval * 1000000LL
 #endif
             );
 
-      slock_unlock(save->cond_lock);
+      slock_unlock(state->cond_lock);
    }
 }
 
@@ -153,7 +231,6 @@ static void autosave_thread(void *data)
  * @path            : path to autosave file
  * @data            : pointer to buffer
  * @size            : size of @data buffer
- * @interval        : interval at which saves should be performed.
  *
  * Create and initialize autosave object.
  *
@@ -161,19 +238,14 @@ static void autosave_thread(void *data)
  * NULL.
  **/
 static autosave_t *autosave_new(const char *path,
-      const void *data, size_t size,
-      unsigned interval, bool compress)
+      const void *data, size_t size)
 {
    void       *buf               = NULL;
    autosave_t *handle            = (autosave_t*)malloc(sizeof(*handle));
    if (!handle)
       return NULL;
 
-   handle->flags                 = 0;
    handle->bufsize               = size;
-   handle->interval              = interval;
-   if (compress)
-      handle->flags             |= AUTOSAVE_FLAG_COMPRESS_FILES;
    handle->retro_buffer          = data;
    handle->path                  = path;
 
@@ -187,11 +259,6 @@ static autosave_t *autosave_new(const char *path,
 
    memcpy(handle->buffer, handle->retro_buffer, handle->bufsize);
 
-   handle->lock                  = slock_new();
-   handle->cond_lock             = slock_new();
-   handle->cond                  = scond_new();
-   handle->thread                = sthread_create(autosave_thread, handle);
-
    return handle;
 }
 
@@ -203,16 +270,6 @@ static autosave_t *autosave_new(const char *path,
  **/
 static void autosave_free(autosave_t *handle)
 {
-   slock_lock(handle->cond_lock);
-   handle->flags |= AUTOSAVE_FLAG_QUIT;
-   slock_unlock(handle->cond_lock);
-   scond_signal(handle->cond);
-   sthread_join(handle->thread);
-
-   slock_free(handle->lock);
-   slock_free(handle->cond_lock);
-   scond_free(handle->cond);
-
    if (handle->buffer)
       free(handle->buffer);
    handle->buffer = NULL;
@@ -238,8 +295,12 @@ bool autosave_init(void)
             sizeof(*autosave_state.list))))
       return false;
 
-   autosave_state.list = list;
-   autosave_state.num  = (unsigned)task_save_files->size;
+   autosave_state.list     = list;
+   autosave_state.num      = (unsigned)task_save_files->size;
+   autosave_state.interval = autosave_interval;
+   autosave_state.flags    = 0;
+   if (compress_files)
+      autosave_state.flags |= AUTOSAVE_FLAG_COMPRESS_FILES;
 
    for (i = 0; i < task_save_files->size; i++)
    {
@@ -257,9 +318,7 @@ bool autosave_init(void)
 
       if (!(auto_st = autosave_new(path,
             mem_info.data,
-            mem_info.size,
-            autosave_interval,
-            compress_files)))
+            mem_info.size)))
       {
          RARCH_WARN("%s\n", msg_hash_to_str(MSG_AUTOSAVE_FAILED));
          continue;
@@ -268,6 +327,11 @@ bool autosave_init(void)
       autosave_state.list[i] = auto_st;
    }
 
+   autosave_state.lock      = slock_new();
+   autosave_state.cond_lock = slock_new();
+   autosave_state.cond      = scond_new();
+   autosave_state.thread    = sthread_create(autosave_thread, &autosave_state);
+
    return true;
 }
 
@@ -275,6 +339,15 @@ void autosave_deinit(void)
 {
    unsigned i;
 
+   if (autosave_state.thread)
+   {
+      slock_lock(autosave_state.cond_lock);
+      autosave_state.flags |= AUTOSAVE_FLAG_QUIT;
+      slock_unlock(autosave_state.cond_lock);
+      scond_signal(autosave_state.cond);
+      sthread_join(autosave_state.thread);
+   }
+
    for (i = 0; i < autosave_state.num; i++)
    {
       autosave_t *handle = autosave_state.list[i];
@@ -288,8 +361,14 @@ void autosave_deinit(void)
 
    free(autosave_state.list);
 
-   autosave_state.list     = NULL;
-   autosave_state.num      = 0;
+   if (autosave_state.lock)
+      slock_free(autosave_state.lock);
+   if (autosave_state.cond_lock)
+      slock_free(autosave_state.cond_lock);
+   if (autosave_state.cond)
+      scond_free(autosave_state.cond);
+
+   memset(&autosave_state, 0, sizeof(autosave_state));
 }
 
 /**
@@ -299,14 +378,8 @@ void autosave_deinit(void)
  **/
 void autosave_lock(void)
 {
-   unsigned i;
-
-   for (i = 0; i < autosave_state.num; i++)
-   {
-      autosave_t *handle = autosave_state.list[i];
-      if (handle)
-         slock_lock(handle->lock);
-   }
+   if (autosave_state.lock)
+      slock_lock(autosave_state.lock);
 }
 
 /**
@@ -316,14 +389,8 @@ void autosave_lock(void)
  **/
 void autosave_unlock(void)
 {
-   unsigned i;
-
-   for (i = 0; i < autosave_state.num; i++)
-   {
-      autosave_t *handle = autosave_state.list[i];
-      if (handle)
-         slock_unlock(handle->lock);
-   }
+   if (autosave_state.lock)
+      slock_unlock(autosave_state.lock);
 }
 #endif
 
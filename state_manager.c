@@ -34,6 +34,7 @@
 #include "retroarch.h"
 #include "verbosity.h"
 #include "content.h"
+#include "trace.h"
 #include "audio/audio_driver.h"
 
 #ifdef HAVE_NETWORKING
@@ -506,6 +507,8 @@ static void state_manager_push_do(state_manager_t *state)
 {
    uint8_t *swap = NULL;
 
+   TRACE_BEGIN("state_manager_push_do");
+
 #if STRICT_BUF_SIZE
    memcpy(state->nextblock, state->debugblock, state->debugsize);
 #endif
@@ -517,6 +520,7 @@ static void state_manager_push_do(state_manager_t *state)
       size_t headpos, tailpos, remaining;
       if (state->capacity < sizeof(size_t) + state->maxcompsize) {
          RARCH_ERR("State capacity insufficient\n");
+         TRACE_END("state_manager_push_do");
          return;
       }
 
@@ -559,6 +563,8 @@ recheckcapacity:;
    state->nextblock          = swap;
 
    state->entries++;
+
+   TRACE_END("state_manager_push_do");
 }
 
 #if 0
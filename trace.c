@@ -0,0 +1,218 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2023 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <compat/strl.h>
+#include <features/features_cpu.h>
+#include <formats/rjson.h>
+#include <queues/task_queue.h>
+#include <streams/file_stream.h>
+#include <retro_miscellaneous.h>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+#include "trace.h"
+#include "verbosity.h"
+
+volatile bool trace_active = false;
+
+static trace_buffer_t trace_buffers[TRACE_MAX_THREADS];
+static volatile unsigned trace_num_buffers = 0;
+static char trace_path[PATH_MAX_LENGTH];
+#ifdef HAVE_THREADS
+static slock_t *trace_lock                 = NULL;
+#endif
+
+static trace_buffer_t *trace_get_buffer(void)
+{
+   unsigned i;
+   trace_buffer_t *buf = NULL;
+#ifdef HAVE_THREADS
+   uintptr_t thread_id = sthread_get_current_thread_id();
+#else
+   uintptr_t thread_id = 0;
+#endif
+
+   for (i = 0; i < trace_num_buffers; i++)
+      if (trace_buffers[i].thread_id == thread_id)
+         return &trace_buffers[i];
+
+   /* First event on this thread, claim a buffer */
+#ifdef HAVE_THREADS
+   slock_lock(trace_lock);
+#endif
+   if (trace_num_buffers < TRACE_MAX_THREADS)
+   {
+      buf            = &trace_buffers[trace_num_buffers];
+      buf->events    = (trace_event_t*)calloc(TRACE_BUFFER_SIZE,
+            sizeof(*buf->events));
+      buf->thread_id = thread_id;
+      buf->head      = 0;
+      /* Publish only once the slot is filled in */
+      if (buf->events)
+         trace_num_buffers++;
+      else
+         buf        = NULL;
+   }
+#ifdef HAVE_THREADS
+   slock_unlock(trace_lock);
+#endif
+
+   return buf;
+}
+
+void trace_push(const char *name, char phase)
+{
+   trace_event_t *ev;
+   trace_buffer_t *buf = trace_get_buffer();
+
+   if (!buf)
+      return;
+
+   ev        = &buf->events[buf->head & (TRACE_BUFFER_SIZE - 1)];
+   ev->name  = name;
+   ev->ts    = cpu_features_get_time_usec();
+   ev->phase = phase;
+   buf->head++;
+}
+
+static void trace_task_cb(retro_task_t *task, bool begin)
+{
+   if (trace_active)
+      trace_push("task", begin ? 'B' : 'E');
+}
+
+bool trace_init(const char *path)
+{
+   if (trace_active)
+      return true;
+
+#ifdef HAVE_THREADS
+   if (!trace_lock && !(trace_lock = slock_new()))
+      return false;
+#endif
+
+   strlcpy(trace_path, path, sizeof(trace_path));
+   task_queue_set_trace_cb(trace_task_cb);
+   trace_active = true;
+   return true;
+}
+
+bool trace_dump(const char *path)
+{
+   unsigned i;
+   RFILE *file;
+   rjsonwriter_t *writer;
+   unsigned num_buffers = trace_num_buffers;
+   bool first           = true;
+
+   if (!path || !*path)
+      path = trace_path;
+   if (!*path)
+      return false;
+
+   if (!(file = filestream_open(path, RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+   {
+      RARCH_ERR("[Trace]: Failed to open \"%s\".\n", path);
+      return false;
+   }
+
+   if (!(writer = rjsonwriter_open_rfile(file)))
+   {
+      filestream_close(file);
+      return false;
+   }
+
+   rjsonwriter_raw(writer, "{\"traceEvents\":[", 16);
+
+   for (i = 0; i < num_buffers; i++)
+   {
+      uint32_t j;
+      trace_buffer_t *buf = &trace_buffers[i];
+      uint32_t head       = buf->head;
+      uint32_t tail       = (head > TRACE_BUFFER_SIZE)
+         ? head - TRACE_BUFFER_SIZE
+         : 0;
+
+      for (j = tail; j < head; j++)
+      {
+         const trace_event_t *ev = &buf->events[j & (TRACE_BUFFER_SIZE - 1)];
+
+         if (!ev->name)
+            continue;
+
+         if (!first)
+            rjsonwriter_raw(writer, ",", 1);
+         rjsonwriter_raw(writer, "\n", 1);
+         first = false;
+
+         rjsonwriter_raw(writer, "{\"name\":", 8);
+         rjsonwriter_add_string(writer, ev->name);
+         rjsonwriter_rawf(writer,
+               ",\"ph\":\"%c\",\"ts\":%lld,\"pid\":0,\"tid\":%u}",
+               ev->phase, (long long)ev->ts, i);
+      }
+   }
+
+   rjsonwriter_raw(writer, "\n],\"displayTimeUnit\":\"ms\"}\n", 27);
+
+   if (!rjsonwriter_free(writer))
+   {
+      filestream_close(file);
+      RARCH_ERR("[Trace]: Failed to write \"%s\".\n", path);
+      return false;
+   }
+
+   filestream_close(file);
+   RARCH_LOG("[Trace]: Wrote \"%s\".\n", path);
+   return true;
+}
+
+void trace_deinit(void)
+{
+   unsigned i;
+
+   if (!trace_active)
+      return;
+
+   /* Callers are expected to have stopped all other
+    * threads by now, nothing may push past this point */
+   trace_active = false;
+   task_queue_set_trace_cb(NULL);
+
+   trace_dump(NULL);
+
+   for (i = 0; i < trace_num_buffers; i++)
+   {
+      free(trace_buffers[i].events);
+      memset(&trace_buffers[i], 0, sizeof(trace_buffers[i]));
+   }
+   trace_num_buffers = 0;
+   trace_path[0]     = '\0';
+
+#ifdef HAVE_THREADS
+   slock_free(trace_lock);
+   trace_lock        = NULL;
+#endif
+}
@@ -0,0 +1,110 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2023 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+#include <libretro.h>
+
+RETRO_BEGIN_DECLS
+
+/* Events kept per thread, must be a power of two */
+#define TRACE_BUFFER_SIZE  (1 << 14)
+#define TRACE_MAX_THREADS  16
+
+/* Scope macros. When tracing is disabled each one
+ * costs a single load and a predictable branch.
+ * @name must be a string literal, only the pointer
+ * is stored. */
+#define TRACE_BEGIN(name) \
+   if (trace_active) \
+      trace_push(name, 'B')
+
+#define TRACE_END(name) \
+   if (trace_active) \
+      trace_push(name, 'E')
+
+typedef struct trace_event
+{
+   const char *name;
+   retro_time_t ts;                /* usec */
+   char phase;                     /* 'B'egin or 'E'nd */
+} trace_event_t;
+
+/* Only the owning thread writes to a buffer,
+ * so pushing an event takes no lock */
+typedef struct trace_buffer
+{
+   trace_event_t *events;
+   uintptr_t thread_id;
+   volatile uint32_t head;         /* total events ever written */
+} trace_buffer_t;
+
+extern volatile bool trace_active;
+
+/**
+ * trace_init:
+ * @path               : file the trace is written to.
+ *
+ * Starts recording trace events. Must be called
+ * from the main thread.
+ *
+ * Returns: true on success.
+ **/
+bool trace_init(const char *path);
+
+/**
+ * trace_deinit:
+ *
+ * Writes the trace to the path given to trace_init(),
+ * then stops recording and releases all buffers.
+ **/
+void trace_deinit(void);
+
+/**
+ * trace_push:
+ * @name               : scope name, with static lifetime.
+ * @phase              : 'B' or 'E'.
+ *
+ * Appends an event to the calling thread's ring buffer,
+ * overwriting the oldest one once the buffer is full.
+ * Use the TRACE_BEGIN/TRACE_END macros instead of
+ * calling this directly.
+ **/
+void trace_push(const char *name, char phase);
+
+/**
+ * trace_dump:
+ * @path               : output file, or NULL for the
+ *                       path given to trace_init().
+ *
+ * Writes the events currently held by all threads in
+ * Chrome trace event format, which can be opened with
+ * chrome://tracing or https://ui.perfetto.dev.
+ * Threads keep recording while the dump runs, so the
+ * oldest events of a busy thread may be inconsistent.
+ *
+ * Returns: true on success.
+ **/
+bool trace_dump(const char *path);
+
+RETRO_END_DECLS
+
+#endif